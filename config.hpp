@@ -9,12 +9,59 @@ namespace RadarConfig {
     constexpr int NUM_SAMPLES = 256;       // Number of samples per chirp (S)
     constexpr double WAVELENGTH = 0.03;     // Wavelength in meters (lambda)
     constexpr double ANTENNA_SPACING = WAVELENGTH / 2.0; // Antenna spacing in meters (d)
+    constexpr double TX_ANTENNA_SPACING = NUM_RECEIVERS * ANTENNA_SPACING; // TX spacing in meters: virtual array fills a ULA
     constexpr int SAMPLE_SIZE_BYTES = 2;    // Size of one sample in bytes (real + imaginary)
 
     constexpr double PI = 3.14159265359;    // Mathematical constant Pi
 	constexpr int TRAINING_CELLS = 10; // Number of training cells for CFAR
 	constexpr int GUARD_CELLS = 2; // Number of guard cells for CFAR
 	constexpr double FALSE_ALARM_RATE = 0.01; // False alarm rate for CFAR
+	constexpr double OS_CFAR_RANK = 0.75; // OS-CFAR noise estimate: rank within the training cells (fraction)
+	constexpr int PEAK_GROUPING_RADIUS = 1; // Detections must be the maximum of their (2r+1)^2 neighbourhood
+	constexpr double MUSIC_GRID_LIMIT_DEG = 90.0; // MUSIC search covers +-limit in azimuth and elevation
+	constexpr double MUSIC_GRID_STEP_DEG = 1.0; // MUSIC search grid spacing in degrees (exhaustive scan)
+	constexpr double MUSIC_COARSE_STEP_DEG = 5.0; // Coarse grid of the coarse-to-fine MUSIC search
+	constexpr double MUSIC_FINE_STEP_DEG = 0.1; // Final step of the refinement before interpolation
+	constexpr int MUSIC_REFINE_CANDIDATES = 3; // Coarse-grid maxima refined per peak
+
+    // FFT kernel used by fftProcessing::fft and the FFT pipeline stages
+    enum class FftEngine {
+        Radix2,     // Textbook radix-2 Cooley-Tukey
+        Radix4      // Radix-4 stages (plus one radix-2 stage for odd log2 lengths)
+    };
+
+    // Sample type used by the FFT, CFAR, MIMO and DOA stages
+    enum class SamplePrecision {
+        Double,     // std::complex<double>
+        Single      // std::complex<float>: half the memory traffic, ~1e-7 relative error
+    };
+
+    // How the CFAR stage sums its training cells
+    enum class CfarEngine {
+        Direct,         // Walk the (2T+1)^2 window of every cell
+        IntegralImage,  // Outer box minus guard box from a summed-area table
+        SlidingWindow   // Running sums along range, then along Doppler
+    };
+
+    // Noise estimate used by the CFAR stage. GreatestOf / SmallestOf split the training window
+    // along range into a leading (s' <= s) and a lagging (s' >= s) half. Both halves include the
+    // Doppler-only column s' = s, so together they cover the same training cells as
+    // CellAveraging. Their interior cells run on SSE2 where available. OrderedStatistic selects
+    // from a sliding histogram: its updates are scattered increments and its selection cursor
+    // moves data-dependently, so that pass stays scalar.
+    enum class CfarMode {
+        CellAveraging,      // Mean of all training cells
+        GreatestOf,         // Larger of the leading and lagging range half-window means
+        SmallestOf,         // Smaller of the two half-window means
+        OrderedStatistic    // k-th smallest training cell
+    };
+
+    // How the MUSIC stage searches its spectrum
+    enum class MusicSearch {
+        Exhaustive,     // Every point of the MUSIC_GRID_STEP_DEG grid
+        CoarseToFine    // Coarse grid, then refine the best maxima with parabolic interpolation
+    };
+
     // Runtime-configurable parameters
     struct Config {
         int num_receivers;        // Number of receivers
@@ -23,6 +70,23 @@ namespace RadarConfig {
         int num_samples;          // Number of samples
         double wavelength;        // Wavelength in meters
         double antenna_spacing;   // Antenna spacing in meters
+        double tx_antenna_spacing; // Transmit antenna spacing in meters (TDM-MIMO virtual array)
+        FftEngine fft_engine;     // FFT kernel selection
+        bool doppler_major_output; // Leave the cube R x S x C after the Doppler FFT
+        bool fused_range_fft;     // One FFT per chirp instead of Hilbert + range FFT
+        bool real_adc_input;      // Frames hold real ADC samples: use the real-input range FFT
+        SamplePrecision precision; // Processing precision of the signal chain
+        bool range_dc_removal;    // Subtract each chirp's mean during raw ingest
+        bool range_window;        // Hanning window over the samples during raw ingest
+        CfarEngine cfar_engine;   // Training-cell summation used by cell-averaging CFAR
+        CfarMode cfar_mode;       // CFAR noise estimate
+        double cfar_os_rank;      // OS-CFAR rank as a fraction of the training cells
+        int peak_grouping_radius; // Local-maximum grouping radius; 0 keeps every detection
+        unsigned num_threads;     // Threads for the parallel stages; 0 uses every hardware thread
+        MusicSearch music_search; // MUSIC spectrum search strategy
+        double music_coarse_step_deg; // Coarse grid step of the coarse-to-fine search
+        double music_fine_step_deg; // Final refinement step before parabolic interpolation
+        int music_refine_candidates; // Coarse maxima refined per peak
 
         // Default constructor initializes with compile-time constants
         Config()
@@ -31,7 +95,24 @@ namespace RadarConfig {
             num_chirps(NUM_CHIRPS),
             num_samples(NUM_SAMPLES),
             wavelength(WAVELENGTH),
-            antenna_spacing(ANTENNA_SPACING) {
+            antenna_spacing(ANTENNA_SPACING),
+            tx_antenna_spacing(TX_ANTENNA_SPACING),
+            fft_engine(FftEngine::Radix4),
+            doppler_major_output(false),
+            fused_range_fft(true),
+            real_adc_input(true),
+            precision(SamplePrecision::Double),
+            range_dc_removal(false),
+            range_window(false),
+            cfar_engine(CfarEngine::IntegralImage),
+            cfar_mode(CfarMode::CellAveraging),
+            cfar_os_rank(OS_CFAR_RANK),
+            peak_grouping_radius(PEAK_GROUPING_RADIUS),
+            num_threads(0),
+            music_search(MusicSearch::CoarseToFine),
+            music_coarse_step_deg(MUSIC_COARSE_STEP_DEG),
+            music_fine_step_deg(MUSIC_FINE_STEP_DEG),
+            music_refine_candidates(MUSIC_REFINE_CANDIDATES) {
         }
     };
     // Function to load configuration (implemented in config.cpp)
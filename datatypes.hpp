@@ -5,27 +5,40 @@
 #include <complex> 
 #include <cstdint> // Include for int16_t
 #include <tuple> // Include for std::tuple
+#include "radar_cube.hpp"
 
 namespace RadarData {
     // Define Real as a 16-bit integer
     using Real = double;
 	using Complex = std::complex<double>;
-    // Define Frame as a 3D vector: receivers x chirps x samples
-    using Frame = std::vector<std::vector<std::vector<Complex>>>;
+    using ComplexF = std::complex<float>;
+    // Define Frame as a contiguous 3D cube: receivers x chirps x samples
+    using Frame = RadarCube;
+    // Single-precision frame for the float processing mode
+    using FrameF = RadarCubeF;
+    // Frame of raw int16 ADC samples as stored by the frame loaders
+    using RawFrame = RawRadarCube;
     // Function to initialize the frame with random 16-bit integer values
     Frame initialize_frame(int num_receivers, int num_chirps, int num_samples, int frameIndex);
 
     // Function to calculate frame size in bytes
     size_t frame_size_bytes(const Frame& frame);
+    size_t frame_size_bytes(const FrameF& frame);
+    size_t frame_size_bytes(const RawFrame& frame);
 
-    // Define NCI, folded NCI, noise estimation, thresholding map, and Peak List
-    using NCI = std::vector<std::vector<Real>>;
-    using FoldedNCI = std::vector<std::vector<Real>>;
-    using NoiseEstimation = std::vector<std::vector<Real>>;
-    using ThresholdingMap = std::vector<std::vector<Real>>;
+    // Define NCI, folded NCI, noise estimation, thresholding map, and Peak List. The CFAR maps
+    // are single-receiver chirps x samples maps held contiguously, in the scale of the tested map
+    using NCI = MagnitudeMap;
+    using FoldedNCI = MagnitudeMap;
+    using NoiseEstimation = MagnitudeMap;
+    using ThresholdingMap = MagnitudeMap;
     using PeakList = std::vector<std::tuple<int, int, int>>;
-    using PeakSnaps = std::vector<std::vector<std::complex<double>>>;
-	using PeakSnap = std::vector<std::complex<double>>;
+    // Peak snaps: one contiguous row of receiver samples per peak, read through PeakSnap views
+    using PeakSnaps = SnapshotMatrix;
+    using PeakSnap = Span<const std::complex<double>>;
+    // Peak snaps of either precision, as produced by the templated MIMO stage
+    template <typename T>
+    using BasicPeakSnaps = BasicSnapshotMatrix<T>;
 }
 
 #endif // DATA_TYPES_H
\ No newline at end of file
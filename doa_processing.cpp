@@ -1,20 +1,22 @@
 #include "doa_processing.hpp"
 #include "config.hpp"
+#include "hermitian_eigen.hpp"
 #include <cmath>
 #include <iostream>
 #include <vector>
 #include <complex>
-#include <algorithm> // For std::sort
-#include <numeric>   // For std::inner_product
+#include <algorithm> // For std::partial_sort
+#include <limits>
 
 namespace DOAProcessing {
     using namespace std;
 
     // Helper function to compute the Hermitian (conjugate transpose) of a matrix
-    vector<vector<complex<double>>> hermitian(const vector<vector<complex<double>>>& matrix) {
+    template <typename T>
+    ComplexMatrix<T> hermitian(const ComplexMatrix<T>& matrix) {
         size_t rows = matrix.size();
         size_t cols = matrix[0].size();
-        vector<vector<complex<double>>> result(cols, vector<complex<double>>(rows));
+        ComplexMatrix<T> result(cols, vector<complex<T>>(rows));
 
         for (size_t i = 0; i < rows; ++i) {
             for (size_t j = 0; j < cols; ++j) {
@@ -25,12 +27,13 @@ namespace DOAProcessing {
     }
 
     // Helper function to multiply two matrices
-    vector<vector<complex<double>>> multiply(const vector<vector<complex<double>>>& A,
-        const vector<vector<complex<double>>>& B) {
+    template <typename T>
+    ComplexMatrix<T> multiply(const ComplexMatrix<T>& A,
+        const ComplexMatrix<T>& B) {
         size_t rows = A.size();
         size_t cols = B[0].size();
         size_t inner = B.size();
-        vector<vector<complex<double>>> result(rows, vector<complex<double>>(cols, { 0.0, 0.0 }));
+        ComplexMatrix<T> result(rows, vector<complex<T>>(cols, { 0.0, 0.0 }));
 
         for (size_t i = 0; i < rows; ++i) {
             for (size_t j = 0; j < cols; ++j) {
@@ -43,9 +46,10 @@ namespace DOAProcessing {
     }
 
     // Helper function to compute the covariance matrix
-    vector<vector<complex<double>>> compute_covariance(const vector<complex<double>>& snap) {
+    template <typename T>
+    ComplexMatrix<T> compute_covariance(RadarData::Span<const complex<T>> snap) {
         size_t num_receivers = snap.size();
-        vector<vector<complex<double>>> R(num_receivers, vector<complex<double>>(num_receivers, { 0.0, 0.0 }));
+        ComplexMatrix<T> R(num_receivers, vector<complex<T>>(num_receivers, { 0.0, 0.0 }));
 
         for (size_t i = 0; i < num_receivers; ++i) {
             for (size_t j = 0; j < num_receivers; ++j) {
@@ -56,19 +60,20 @@ namespace DOAProcessing {
     }
 
     // Helper function to perform eigenvalue decomposition manually
-    pair<vector<double>, vector<vector<complex<double>>>> eigen_decomposition(
-        vector<vector<complex<double>>>& matrix, int max_iters, double tol) {
+    template <typename T>
+    pair<vector<T>, ComplexMatrix<T>> eigen_decomposition(
+        ComplexMatrix<T>& matrix, int max_iters, double tol) {
         size_t n = matrix.size();
-        vector<double> eigenvalues(n, 0.0);
-        vector<vector<complex<double>>> eigenvectors(n, vector<complex<double>>(n, { 0.0, 0.0 }));
+        vector<T> eigenvalues(n, 0);
+        ComplexMatrix<T> eigenvectors(n, vector<complex<T>>(n, { 0.0, 0.0 }));
 
         for (size_t k = 0; k < n; ++k) {
-            vector<complex<double>> eigenvector(n, { 1.0, 0.0 }); // Initial guess
-            double eigenvalue = 0.0;
+            vector<complex<T>> eigenvector(n, { 1.0, 0.0 }); // Initial guess
+            T eigenvalue = 0;
 
             for (int iter = 0; iter < max_iters; ++iter) {
                 // Multiply matrix by the current eigenvector
-                vector<complex<double>> next_vector(n, { 0.0, 0.0 });
+                vector<complex<T>> next_vector(n, { 0.0, 0.0 });
                 for (size_t i = 0; i < n; ++i) {
                     for (size_t j = 0; j < n; ++j) {
                         next_vector[i] += matrix[i][j] * eigenvector[j];
@@ -76,7 +81,7 @@ namespace DOAProcessing {
                 }
 
                 // Normalize the resulting vector
-                double norm = 0.0;
+                T norm = 0;
                 for (const auto& val : next_vector) {
                     norm += std::norm(val);
                 }
@@ -86,7 +91,7 @@ namespace DOAProcessing {
                 }
 
                 // Compute the Rayleigh quotient for the eigenvalue
-                double next_eigenvalue = 0.0;
+                T next_eigenvalue = 0;
                 for (size_t i = 0; i < n; ++i) {
                     next_eigenvalue += real(conj(next_vector[i]) * eigenvector[i]);
                 }
@@ -116,71 +121,292 @@ namespace DOAProcessing {
         return make_pair(eigenvalues, eigenvectors);
     }
 
-    void compute_music_doa(const RadarData::PeakSnaps& peakSnaps,
+    namespace {
+        // Refinement moves allowed per candidate before the step is halved regardless
+        constexpr int MAX_REFINE_MOVES = 32;
+        // Floor on the final refinement step, so a zero step cannot stall the search
+        constexpr double MIN_FINE_STEP_DEG = 1e-6;
+
+        // |e^H a|^2 for an n-element eigenvector e and steering vector a
+        template <typename T>
+        inline double projection_power(const complex<T>* e, const complex<T>* a, int n) {
+            T re = 0, im = 0;
+            for (int i = 0; i < n; ++i) {
+                re += e[i].real() * a[i].real() + e[i].imag() * a[i].imag();
+                im += e[i].real() * a[i].imag() - e[i].imag() * a[i].real();
+            }
+            return static_cast<double>(re) * re + static_cast<double>(im) * im;
+        }
+
+        // Power of a steering vector in the noise subspace: the MUSIC spectrum is its inverse, and
+        // it does not depend on the basis the eigensolver picked for the subspace
+        template <typename T>
+        inline double noise_power(const complex<T>* noiseSubspace, int num_noise, const complex<T>* a, int n) {
+            double power = 0.0;
+            for (int k = 0; k < num_noise; ++k) {
+                power += projection_power(noiseSubspace + k * MAX_EIGEN_SIZE, a, n);
+            }
+            return power;
+        }
+
+        // Point of the spectrum search with its noise power
+        struct SearchPoint {
+            double azimuth;
+            double elevation;
+            double power;
+        };
+
+        // Noise power at an off-grid angle; infinite outside the limits of the table
+        template <typename T>
+        double noise_power_at(const BasicSteeringTable<T>& steering, const complex<T>* noiseSubspace, int num_noise,
+            double azimuth, double elevation) {
+            const double limit = steering.limit_deg();
+            if (std::abs(azimuth) > limit || std::abs(elevation) > limit) {
+                return numeric_limits<double>::infinity();
+            }
+            complex<T> a[MAX_EIGEN_SIZE];
+            steering.steer(azimuth, elevation, a);
+            return noise_power(noiseSubspace, num_noise, a, steering.num_elements());
+        }
+
+        // Vertex offset, in steps, of the parabola through (-1, before), (0, center), (1, after);
+        // zero unless the samples bracket a minimum
+        inline double parabolic_offset(double before, double center, double after) {
+            const double curvature = before - 2.0 * center + after;
+            if (!std::isfinite(curvature) || !(curvature > 0.0)) {
+                return 0.0;
+            }
+            return std::max(-0.5, std::min(0.5, 0.5 * (before - after) / curvature));
+        }
+
+        // Pattern search from a coarse-grid maximum: move to the best of the 3 x 3 window at the
+        // current step until the center wins, then halve the step until it reaches fine_step, and
+        // finish with a parabolic fit along each axis of the last window
+        template <typename T>
+        SearchPoint refine_maximum(const BasicSteeringTable<T>& steering, const complex<T>* noiseSubspace, int num_noise,
+            SearchPoint best, double step, double fine_step) {
+            double window[3][3];
+            int moves = 0;
+            for (;;) {
+                int bestI = 1, bestJ = 1;
+                double bestPower = best.power;
+                for (int i = 0; i < 3; ++i) {
+                    for (int j = 0; j < 3; ++j) {
+                        window[i][j] = (i == 1 && j == 1) ? best.power : noise_power_at(steering, noiseSubspace, num_noise,
+                            best.azimuth + (i - 1) * step, best.elevation + (j - 1) * step);
+                        if (window[i][j] < bestPower) {
+                            bestPower = window[i][j];
+                            bestI = i;
+                            bestJ = j;
+                        }
+                    }
+                }
+                if ((bestI != 1 || bestJ != 1) && moves < MAX_REFINE_MOVES) {
+                    best = { best.azimuth + (bestI - 1) * step, best.elevation + (bestJ - 1) * step, bestPower };
+                    ++moves;
+                    continue;
+                }
+                if (step <= fine_step) {
+                    break;
+                }
+                step *= 0.5;
+                moves = 0;
+            }
+
+            // The window is centered on 'best' here; keep the fit only if it does not lose power
+            SearchPoint fitted = best;
+            fitted.azimuth += parabolic_offset(window[0][1], window[1][1], window[2][1]) * step;
+            fitted.elevation += parabolic_offset(window[1][0], window[1][1], window[1][2]) * step;
+            fitted.power = noise_power_at(steering, noiseSubspace, num_noise, fitted.azimuth, fitted.elevation);
+            return fitted.power <= best.power ? fitted : best;
+        }
+    }
+
+    template <typename T>
+    void BasicSteeringTable<T>::build(const vector<MIMOSynthesis::ElementPosition>& positions, double wavelength,
+        double limit_deg, double step_deg) {
+        num_elements_ = static_cast<int>(positions.size());
+        limit_deg_ = limit_deg;
+        step_deg_ = step_deg;
+        num_angles_ = step_deg > 0.0 ? static_cast<int>(std::floor(2.0 * limit_deg / step_deg + 0.5)) + 1 : 0;
+        vectors_.resize(size() * num_elements_);
+        positions_ = positions;
+        wavenumber_ = 2.0 * RadarConfig::PI / wavelength;
+
+        for (int a = 0; a < num_angles_; ++a) {
+            for (int e = 0; e < num_angles_; ++e) {
+                steer(angle(a), angle(e), vectors_.data() + (static_cast<size_t>(a) * num_angles_ + e) * num_elements_);
+            }
+        }
+    }
+
+    template <typename T>
+    void BasicSteeringTable<T>::steer(double azimuth_deg, double elevation_deg, complex<T>* out) const {
+        const double elevationRad = elevation_deg * RadarConfig::PI / 180.0;
+        const double horizontal = sin(azimuth_deg * RadarConfig::PI / 180.0) * cos(elevationRad);
+        const double vertical = sin(elevationRad);
+        for (int i = 0; i < num_elements_; ++i) {
+            const double phase = wavenumber_ * (positions_[i].horizontal * horizontal + positions_[i].vertical * vertical);
+            out[i] = complex<T>(static_cast<T>(cos(phase)), static_cast<T>(sin(phase)));
+        }
+    }
+
+    template <typename T>
+    void compute_music_doa(const RadarData::BasicPeakSnaps<T>& peakSnaps, const BasicSteeringTable<T>& steering,
         vector<pair<double, double>>& doaResults,
-        int num_sources) {
+        int num_sources, const RadarConfig::Config& rconfig) {
         doaResults.clear();
 
-        // Radar parameters
-        double wavelength = RadarConfig::WAVELENGTH;
-        double d = RadarConfig::ANTENNA_SPACING;
+        const bool refine = rconfig.music_search == RadarConfig::MusicSearch::CoarseToFine;
+        const double fine_step = std::max(rconfig.music_fine_step_deg, MIN_FINE_STEP_DEG);
+        const int num_angles = steering.num_angles();
 
-        // Iterate over each peak snap
-        for (const auto& snap : peakSnaps) {
+        // Noise power over the grid and the coarse maxima, reused across peaks and calls
+        thread_local vector<double> gridPower;
+        thread_local vector<pair<double, int>> candidates;
+        gridPower.resize(steering.size());
+
+        // Iterate over each peak snap, read in place from the snapshot matrix
+        for (size_t p = 0; p < peakSnaps.size(); ++p) {
+            RadarData::Span<const complex<T>> snap = peakSnaps[p];
             int num_receivers = snap.size();
             if (num_receivers < num_sources) {
                 cerr << "Insufficient receivers for MUSIC algorithm." << endl;
                 continue;
             }
 
-            // Compute the covariance matrix
-            auto R = compute_covariance(snap);
-
-            // Perform eigenvalue decomposition
-            pair<vector<double>, vector<vector<complex<double>>>> eigen_result =
-                eigen_decomposition(R);
-            vector<double> eigenvalues = eigen_result.first;
-            vector<vector<complex<double>>> eigenvectors = eigen_result.second;
+            if (num_receivers > MAX_EIGEN_SIZE) {
+                cerr << "Too many receivers for the MUSIC eigensolver: " << num_receivers << endl;
+                continue;
+            }
+            if (num_receivers != steering.num_elements()) {
+                cerr << "Steering table of " << steering.num_elements() << " elements does not match a "
+                    << num_receivers << "-receiver snap" << endl;
+                continue;
+            }
 
-            // Separate signal and noise subspaces
-            vector<vector<complex<double>>> noiseSubspace;
-            for (int i = num_sources; i < num_receivers; ++i) {
-                noiseSubspace.push_back(eigenvectors[i]);
+            // Covariance matrix of the snap (upper triangle), decomposed on the stack
+            SmallMatrix<T> R;
+            R.n = num_receivers;
+            for (int i = 0; i < num_receivers; ++i) {
+                for (int j = i; j < num_receivers; ++j) {
+                    R.a[i][j] = snap[i] * conj(snap[j]);
+                }
             }
+            SmallEigen<T> eigen;
+            if (!eigen_hermitian(R, eigen)) {
+                continue;
+            }
+
+            // Noise subspace: eigenvectors of the num_receivers - num_sources smallest eigenvalues
+            const complex<T>* noiseSubspace = eigen.vectors[num_sources];
+            const int num_noise = num_receivers - num_sources;
 
-            // MUSIC spectrum calculation
+            // MUSIC spectrum calculation over the cached steering vectors
             double azimuth = 0.0, elevation = 0.0;
             double max_spectrum = -1.0;
 
-            for (double theta = -90.0; theta <= 90.0; theta += 1.0) {
-                for (double phi = -90.0; phi <= 90.0; phi += 1.0) {
-                    // Steering vector
-                    vector<complex<double>> steering(num_receivers);
-                    for (int i = 0; i < num_receivers; ++i) {
-                        double phase = 2.0 * RadarConfig::PI * d * i *
-                            (sin(theta * RadarConfig::PI / 180.0) *
-                                cos(phi * RadarConfig::PI / 180.0)) / wavelength;
-                        steering[i] = exp(complex<double>(0, phase));
+            for (int a = 0; a < num_angles; ++a) {
+                for (int e = 0; e < num_angles; ++e) {
+                    // Compute MUSIC spectrum: inverse of the steering power in the noise subspace
+                    const double noisePower = noise_power(noiseSubspace, num_noise, steering.row(a, e), num_receivers);
+                    gridPower[static_cast<size_t>(a) * num_angles + e] = noisePower;
+                    double spectrum = 1.0 / noisePower;
+
+                    if (spectrum > max_spectrum) {
+                        max_spectrum = spectrum;
+                        azimuth = steering.angle(a);
+                        elevation = steering.angle(e);
                     }
+                }
+            }
 
-                    // Compute MUSIC spectrum
-                    double spectrum = 0.0;
-                    for (const auto& noiseVec : noiseSubspace) {
-                        double projection = std::abs(std::inner_product(noiseVec.begin(), noiseVec.end(),
-                            steering.begin(), std::complex<double>(0, 0)));
-                        spectrum += 1.0 / (projection * projection);
+            if (refine && num_angles > 0) {
+                // Local maxima of the spectrum (minima of the noise power) over their 8 neighbours,
+                // strongest first, grid order breaking ties
+                candidates.clear();
+                for (int a = 0; a < num_angles; ++a) {
+                    for (int e = 0; e < num_angles; ++e) {
+                        const double power = gridPower[static_cast<size_t>(a) * num_angles + e];
+                        bool isMaximum = true;
+                        for (int da = -1; da <= 1 && isMaximum; ++da) {
+                            for (int de = -1; de <= 1; ++de) {
+                                const int na = a + da, ne = e + de;
+                                if (na < 0 || na >= num_angles || ne < 0 || ne >= num_angles) {
+                                    continue;
+                                }
+                                if (gridPower[static_cast<size_t>(na) * num_angles + ne] < power) {
+                                    isMaximum = false;
+                                    break;
+                                }
+                            }
+                        }
+                        if (isMaximum) {
+                            candidates.emplace_back(power, a * num_angles + e);
+                        }
                     }
+                }
+                const size_t num_refined = std::min(candidates.size(),
+                    static_cast<size_t>(std::max(rconfig.music_refine_candidates, 1)));
+                std::partial_sort(candidates.begin(), candidates.begin() + num_refined, candidates.end());
 
-                    if (spectrum > max_spectrum) {
-                        max_spectrum = spectrum;
-                        azimuth = theta;
-                        elevation = phi;
+                SearchPoint best = { azimuth, elevation, numeric_limits<double>::infinity() };
+                for (size_t c = 0; c < num_refined; ++c) {
+                    const int a = candidates[c].second / num_angles;
+                    const int e = candidates[c].second % num_angles;
+                    const SearchPoint start = { steering.angle(a), steering.angle(e), candidates[c].first };
+                    const SearchPoint refined = refine_maximum(steering, noiseSubspace, num_noise,
+                        start, steering.step_deg(), fine_step);
+                    if (refined.power < best.power) {
+                        best = refined;
                     }
                 }
+                azimuth = best.azimuth;
+                elevation = best.elevation;
             }
 
             // Store the result
             doaResults.emplace_back(azimuth, elevation);
         }
     }
+
+    template <typename T>
+    void compute_music_doa(const RadarData::BasicPeakSnaps<T>& peakSnaps,
+        vector<pair<double, double>>& doaResults,
+        int num_sources, const RadarConfig::Config& rconfig) {
+        // Uniform linear array along the horizontal axis, rebuilt only when the snap length or
+        // the grid step of the configured search changes
+        thread_local BasicSteeringTable<T> steering;
+        const int num_receivers = static_cast<int>(peakSnaps.num_channels());
+        const double step_deg = music_grid_step(rconfig);
+        if (steering.empty() || steering.num_elements() != num_receivers || steering.step_deg() != step_deg) {
+            vector<MIMOSynthesis::ElementPosition> positions;
+            for (int i = 0; i < num_receivers; ++i) {
+                positions.push_back({ i * RadarConfig::ANTENNA_SPACING, 0.0 });
+            }
+            steering.build(positions, RadarConfig::WAVELENGTH, RadarConfig::MUSIC_GRID_LIMIT_DEG, step_deg);
+        }
+        compute_music_doa(peakSnaps, steering, doaResults, num_sources, rconfig);
+    }
+
+    template class BasicSteeringTable<float>;
+    template class BasicSteeringTable<double>;
+    template void compute_music_doa<float>(const RadarData::BasicPeakSnaps<float>& peakSnaps, const SteeringTableF& steering,
+        vector<pair<double, double>>& doaResults, int num_sources, const RadarConfig::Config& rconfig);
+    template void compute_music_doa<double>(const RadarData::BasicPeakSnaps<double>& peakSnaps, const SteeringTable& steering,
+        vector<pair<double, double>>& doaResults, int num_sources, const RadarConfig::Config& rconfig);
+    template void compute_music_doa<float>(const RadarData::BasicPeakSnaps<float>& peakSnaps,
+        vector<pair<double, double>>& doaResults, int num_sources, const RadarConfig::Config& rconfig);
+    template void compute_music_doa<double>(const RadarData::BasicPeakSnaps<double>& peakSnaps,
+        vector<pair<double, double>>& doaResults, int num_sources, const RadarConfig::Config& rconfig);
+    template ComplexMatrix<float> hermitian<float>(const ComplexMatrix<float>& matrix);
+    template ComplexMatrix<double> hermitian<double>(const ComplexMatrix<double>& matrix);
+    template ComplexMatrix<float> multiply<float>(const ComplexMatrix<float>& A, const ComplexMatrix<float>& B);
+    template ComplexMatrix<double> multiply<double>(const ComplexMatrix<double>& A, const ComplexMatrix<double>& B);
+    template ComplexMatrix<float> compute_covariance<float>(RadarData::Span<const complex<float>> snap);
+    template ComplexMatrix<double> compute_covariance<double>(RadarData::Span<const complex<double>> snap);
+    template pair<vector<float>, ComplexMatrix<float>> eigen_decomposition<float>(
+        ComplexMatrix<float>& matrix, int max_iters, double tol);
+    template pair<vector<double>, ComplexMatrix<double>> eigen_decomposition<double>(
+        ComplexMatrix<double>& matrix, int max_iters, double tol);
 }
@@ -5,26 +5,103 @@
 #include <complex>
 #include <utility> // For std::pair
 #include "datatypes.hpp" // For RadarData::PeakSnaps
+#include "mimo_synthesis.hpp" // For MIMOSynthesis::ElementPosition
+#include "config.hpp"
 
 namespace DOAProcessing {
-    // Function to compute MUSIC-based DOA
-    void compute_music_doa(const RadarData::PeakSnaps& peakSnaps,
+    // Matrix of complex values, one inner vector per row
+    template <typename T>
+    using ComplexMatrix = std::vector<std::vector<std::complex<T>>>;
+
+    // Steering vectors of an array over the (azimuth, elevation) search grid, one contiguous row of
+    // num_elements() values per grid point, azimuth-major. They depend only on the geometry and the
+    // grid, so a table is built once per array and shared by every peak. Instantiated for float
+    // and double.
+    template <typename T>
+    class BasicSteeringTable {
+    public:
+        BasicSteeringTable() = default;
+        BasicSteeringTable(const std::vector<MIMOSynthesis::ElementPosition>& positions, double wavelength,
+            double limit_deg = RadarConfig::MUSIC_GRID_LIMIT_DEG, double step_deg = RadarConfig::MUSIC_GRID_STEP_DEG) {
+            build(positions, wavelength, limit_deg, step_deg);
+        }
+
+        // Grid from -limit_deg to +limit_deg in step_deg on both axes; element p gets the phase
+        // 2*pi/wavelength * (horizontal * sin(az) * cos(el) + vertical * sin(el))
+        void build(const std::vector<MIMOSynthesis::ElementPosition>& positions, double wavelength,
+            double limit_deg = RadarConfig::MUSIC_GRID_LIMIT_DEG, double step_deg = RadarConfig::MUSIC_GRID_STEP_DEG);
+
+        int num_elements() const { return num_elements_; }
+        int num_angles() const { return num_angles_; }    // Grid points per axis
+        size_t size() const { return static_cast<size_t>(num_angles_) * num_angles_; }
+        bool empty() const { return size() == 0; }
+        double limit_deg() const { return limit_deg_; }
+        double step_deg() const { return step_deg_; }
+        double angle(int index) const { return -limit_deg_ + index * step_deg_; }
+
+        // Steering vector of grid point (azimuth index, elevation index)
+        const std::complex<T>* row(int azimuth, int elevation) const {
+            return vectors_.data() + (static_cast<size_t>(azimuth) * num_angles_ + elevation) * num_elements_;
+        }
+
+        // Steering vector of an arbitrary (azimuth, elevation) in degrees, off the grid, written to
+        // num_elements() values at 'out'
+        void steer(double azimuth_deg, double elevation_deg, std::complex<T>* out) const;
+
+    private:
+        std::vector<std::complex<T>> vectors_;
+        std::vector<MIMOSynthesis::ElementPosition> positions_;
+        double wavenumber_ = 0.0;
+        int num_elements_ = 0;
+        int num_angles_ = 0;
+        double limit_deg_ = 0.0;
+        double step_deg_ = 1.0;
+    };
+
+    using SteeringTable = BasicSteeringTable<double>;
+    using SteeringTableF = BasicSteeringTable<float>;
+
+    // Grid step a steering table needs for the configured search: the full-resolution grid for
+    // the exhaustive scan, the coarse grid for the coarse-to-fine search
+    inline double music_grid_step(const RadarConfig::Config& rconfig) {
+        return rconfig.music_search == RadarConfig::MusicSearch::CoarseToFine
+            ? rconfig.music_coarse_step_deg : RadarConfig::MUSIC_GRID_STEP_DEG;
+    }
+
+    // Function to compute MUSIC-based DOA, instantiated for double and float snaps: the spectrum is
+    // searched over the cached steering vectors of 'steering', which must match the snap length.
+    // With MusicSearch::Exhaustive the best grid point is returned. With CoarseToFine the
+    // music_refine_candidates best local maxima of the grid are refined by a pattern search that
+    // halves its step down to music_fine_step_deg, and the best is finished with a parabolic fit
+    // on each axis.
+    template <typename T>
+    void compute_music_doa(const RadarData::BasicPeakSnaps<T>& peakSnaps, const BasicSteeringTable<T>& steering,
+        std::vector<std::pair<double, double>>& doaResults,
+        int num_sources, const RadarConfig::Config& rconfig = RadarConfig::Config());
+
+    // Same for a uniform linear array of ANTENNA_SPACING, using a table cached per snap length
+    template <typename T>
+    void compute_music_doa(const RadarData::BasicPeakSnaps<T>& peakSnaps,
         std::vector<std::pair<double, double>>& doaResults,
-        int num_sources);
+        int num_sources, const RadarConfig::Config& rconfig = RadarConfig::Config());
 
     // Helper function to compute the Hermitian (conjugate transpose) of a matrix
-    std::vector<std::vector<std::complex<double>>> hermitian(const std::vector<std::vector<std::complex<double>>>& matrix);
+    template <typename T>
+    ComplexMatrix<T> hermitian(const ComplexMatrix<T>& matrix);
 
     // Helper function to multiply two matrices
-    std::vector<std::vector<std::complex<double>>> multiply(const std::vector<std::vector<std::complex<double>>>& A,
-        const std::vector<std::vector<std::complex<double>>>& B);
+    template <typename T>
+    ComplexMatrix<T> multiply(const ComplexMatrix<T>& A, const ComplexMatrix<T>& B);
 
     // Helper function to compute the covariance matrix
-    std::vector<std::vector<std::complex<double>>> compute_covariance(const std::vector<std::complex<double>>& snap);
+    template <typename T>
+    ComplexMatrix<T> compute_covariance(RadarData::Span<const std::complex<T>> snap);
 
-    // Helper function to perform eigenvalue decomposition manually
-    std::pair<std::vector<double>, std::vector<std::vector<std::complex<double>>>> eigen_decomposition(
-        std::vector<std::vector<std::complex<double>>>& matrix, int max_iters = 1000, double tol = 1e-6);
+    // Helper function to perform eigenvalue decomposition manually (power iteration with
+    // deflation); compute_music_doa uses the small-matrix solvers of hermitian_eigen.hpp
+    template <typename T>
+    std::pair<std::vector<T>, ComplexMatrix<T>> eigen_decomposition(
+        ComplexMatrix<T>& matrix, int max_iters = 1000, double tol = 1e-6);
 }
 
 #endif // DOA_PROCESSING_HPP
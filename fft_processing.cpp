@@ -1,101 +1,602 @@
 #include <vector>
 #include <complex>
+#include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
 #include "fft_processing.hpp"
+#include "fft_simd.hpp"
 #include "datatypes.hpp"
 #include "config.hpp"
 
 namespace fftProcessing {
-    // Iterative FFT implementation
-    void fft(std::vector<std::complex<double>>& data, bool inverse) {
-        const size_t N = data.size();
-        if (N <= 1) return; // Base case
-        // Bit reversal permutation
+    template <typename T>
+    BasicFftPlan<T>::BasicFftPlan(size_t N) : N_(N) {
+        if (N_ <= 1) return;
+        // Bit reversal permutation, stored as the list of swaps it performs
         size_t j = 0;
-        for (size_t i = 1; i < N; ++i) {
-            size_t bit = N >> 1;
+        for (size_t i = 1; i < N_; ++i) {
+            size_t bit = N_ >> 1;
             while (j >= bit) {
                 j -= bit;
                 bit >>= 1;
             }
             j += bit;
-            if (i < j) std::swap(data[i], data[j]);
+            if (i < j) swaps_.emplace_back(static_cast<uint32_t>(i), static_cast<uint32_t>(j));
+        }
+        // Per-stage twiddle tables, each computed directly from its angle so no
+        // rounding error accumulates along a stage. Stage 'len' starts at len/2 - 1.
+        forward_twiddles_.resize(N_ - 1);
+        inverse_twiddles_.resize(N_ - 1);
+        for (size_t len = 2; len <= N_; len <<= 1) {
+            std::complex<T>* forward = &forward_twiddles_[len / 2 - 1];
+            std::complex<T>* inverse = &inverse_twiddles_[len / 2 - 1];
+            for (size_t k = 0; k < len / 2; ++k) {
+                double angle = 2 * RadarConfig::PI * static_cast<double>(k) / static_cast<double>(len);
+                forward[k] = std::complex<T>(static_cast<T>(cos(angle)), static_cast<T>(sin(angle)));
+                inverse[k] = std::conj(forward[k]);
+            }
+        }
+        // Radix-4 stages over the same bit-reversed input. A stage merges four
+        // consecutive sub-transforms of length m holding x[4n], x[4n+2], x[4n+1]
+        // and x[4n+3], which need twiddles w^2k, w^k and w^3k with w = e^(j2pi/4m).
+        size_t log2N = 0;
+        while ((size_t(1) << log2N) < N_) ++log2N;
+        radix4_leading_radix2_ = (log2N % 2) != 0;
+        for (size_t m = radix4_leading_radix2_ ? 2 : 1; 4 * m <= N_; m *= 4) {
+            radix4_stages_.push_back({ m, forward_radix4_twiddles_.size() });
+            for (size_t p = 1; p <= 3; ++p) {
+                for (size_t k = 0; k < m; ++k) {
+                    double angle = 2 * RadarConfig::PI * static_cast<double>(p * k) / static_cast<double>(4 * m);
+                    std::complex<T> w(static_cast<T>(cos(angle)), static_cast<T>(sin(angle)));
+                    forward_radix4_twiddles_.push_back(w);
+                    inverse_radix4_twiddles_.push_back(std::conj(w));
+                }
+            }
+        }
+    }
+
+    template <typename T>
+    void BasicFftPlan<T>::execute(std::complex<T>* data, bool inverse) const {
+        execute(data, inverse, get_fft_engine());
+    }
+
+    template <typename T>
+    void BasicFftPlan<T>::execute(std::complex<T>* data, bool inverse, RadarConfig::FftEngine engine) const {
+        execute_rows(&data, 1, inverse, engine);
+    }
+
+    template <typename T>
+    void BasicFftPlan<T>::execute_batch(std::complex<T>* data, size_t howmany, size_t stride, size_t dist, bool inverse) const {
+        const RadarConfig::FftEngine engine = get_fft_engine();
+        std::complex<T>* rows[FFT_BATCH_ROWS];
+        if (stride == 1) {
+            // Rows are contiguous: transform them in place, FFT_BATCH_ROWS at a time
+            for (size_t first = 0; first < howmany; first += FFT_BATCH_ROWS) {
+                size_t count = std::min(FFT_BATCH_ROWS, howmany - first);
+                for (size_t r = 0; r < count; ++r) {
+                    rows[r] = data + (first + r) * dist;
+                }
+                execute_rows(rows, count, inverse, engine);
+            }
+            return;
+        }
+        // Strided rows are gathered into a contiguous scratch block and scattered back
+        thread_local std::vector<std::complex<T>> scratch;
+        scratch.resize(FFT_BATCH_ROWS * N_);
+        for (size_t first = 0; first < howmany; first += FFT_BATCH_ROWS) {
+            size_t count = std::min(FFT_BATCH_ROWS, howmany - first);
+            for (size_t r = 0; r < count; ++r) {
+                const std::complex<T>* src = data + (first + r) * dist;
+                rows[r] = &scratch[r * N_];
+                for (size_t n = 0; n < N_; ++n) {
+                    rows[r][n] = src[n * stride];
+                }
+            }
+            execute_rows(rows, count, inverse, engine);
+            for (size_t r = 0; r < count; ++r) {
+                std::complex<T>* dst = data + (first + r) * dist;
+                for (size_t n = 0; n < N_; ++n) {
+                    dst[n * stride] = rows[r][n];
+                }
+            }
+        }
+    }
+
+    // Two real rows a and b are transformed as z = a + jb. With Z = FFT(z),
+    // A[k] = (Z[k] + conj(Z[N-k])) / 2 and B[k] = (Z[k] - conj(Z[N-k])) / 2j,
+    // and the upper halves follow from conjugate symmetry.
+    template <typename T>
+    void BasicFftPlan<T>::execute_real_batch(std::complex<T>* data, size_t howmany, size_t stride, size_t dist) const {
+        const size_t N = N_;
+        const size_t pairs = howmany / 2;
+        std::complex<T>* packed[FFT_BATCH_ROWS];
+        std::complex<T>* out_a[FFT_BATCH_ROWS];
+        std::complex<T>* out_b[FFT_BATCH_ROWS];
+        thread_local std::vector<std::complex<T>> scratch;
+        if (stride != 1) {
+            scratch.resize(FFT_BATCH_ROWS * N);
+        }
+        for (size_t first = 0; first < pairs; first += FFT_BATCH_ROWS) {
+            size_t count = std::min(FFT_BATCH_ROWS, pairs - first);
+            // Pack each pair of real rows into one complex row: in place in row a when
+            // rows are contiguous, otherwise in scratch
+            for (size_t p = 0; p < count; ++p) {
+                std::complex<T>* a = data + 2 * (first + p) * dist;
+                const std::complex<T>* b = a + dist;
+                out_a[p] = a;
+                out_b[p] = a + dist;
+                if (stride == 1) {
+                    T* values = reinterpret_cast<T*>(a);
+                    const T* source = reinterpret_cast<const T*>(b);
+                    for (size_t n = 0; n < N; ++n) {
+                        values[2 * n + 1] = source[2 * n];
+                    }
+                    packed[p] = a;
+                }
+                else {
+                    packed[p] = &scratch[p * N];
+                    for (size_t n = 0; n < N; ++n) {
+                        packed[p][n] = std::complex<T>(a[n * stride].real(), b[n * stride].real());
+                    }
+                }
+            }
+            execute_packed_real(packed, count, out_a, out_b, stride);
+        }
+        if (howmany % 2 != 0) {
+            // Odd row out goes through the complex transform
+            execute_batch(data + (howmany - 1) * dist, 1, stride, dist, false);
+        }
+    }
+
+    template <typename T>
+    void BasicFftPlan<T>::execute_packed_real(std::complex<T>* const* packed, size_t count,
+        std::complex<T>* const* out_a, std::complex<T>* const* out_b, size_t stride) const {
+        const size_t N = N_;
+        execute_rows(packed, count, false, get_fft_engine());
+        // Split the packed spectra into the two outputs. Bins k and N-k are read
+        // before either is written, so out_a may be the packed row itself.
+        const T half = static_cast<T>(0.5);
+        for (size_t p = 0; p < count; ++p) {
+            const std::complex<T>* z = packed[p];
+            std::complex<T>* a = out_a[p];
+            std::complex<T>* b = out_b[p];
+            const std::complex<T> z0 = z[0];
+            a[0] = z0.real();
+            b[0] = z0.imag();
+            for (size_t k = 1; k <= N / 2; ++k) {
+                const T zr = z[k].real(), zi = z[k].imag();
+                const T mr = z[N - k].real(), mi = z[N - k].imag();
+                const T ar = half * (zr + mr), ai = half * (zi - mi);
+                const T br = half * (zi + mi), bi = half * (mr - zr);
+                a[k * stride] = std::complex<T>(ar, ai);
+                b[k * stride] = std::complex<T>(br, bi);
+                a[(N - k) * stride] = std::complex<T>(ar, -ai);
+                b[(N - k) * stride] = std::complex<T>(br, -bi);
+            }
+        }
+    }
+
+    // Transform a group of rows together. Each stage is applied to every row before
+    // moving on, so its twiddles are loaded once per group rather than once per row.
+    template <typename T>
+    void BasicFftPlan<T>::execute_rows(std::complex<T>* const* rows, size_t count, bool inverse, RadarConfig::FftEngine engine) const {
+        const size_t N = N_;
+        if (N <= 1) return; // Base case
+        for (size_t r = 0; r < count; ++r) {
+            std::complex<T>* data = rows[r];
+            for (const auto& swap : swaps_) {
+                std::swap(data[swap.first], data[swap.second]);
+            }
+        }
+        if (engine == RadarConfig::FftEngine::Radix4) {
+            execute_radix4(rows, count, inverse);
+        }
+        else {
+            execute_radix2(rows, count, inverse);
+        }
+        if (inverse) {
+            for (size_t r = 0; r < count; ++r) {
+                std::complex<T>* data = rows[r];
+                for (size_t i = 0; i < N; ++i) {
+                    data[i] /= static_cast<T>(N); // Normalize the result
+                }
+            }
         }
+    }
+
+    // Butterfly stages on bit-reversed data, without scaling
+    template <typename T>
+    void BasicFftPlan<T>::execute_radix2(std::complex<T>* const* rows, size_t count, bool inverse) const {
+        const size_t N = N_;
         // Cooley-Tukey FFT
+        const std::vector<std::complex<T>>& twiddles = inverse ? inverse_twiddles_ : forward_twiddles_;
+        const SimdLevel level = get_simd_level();
+        // Complex values per AVX2 / AVX-512 register
+        constexpr size_t avx2_width = 32 / sizeof(std::complex<T>);
+        constexpr size_t avx512_width = 64 / sizeof(std::complex<T>);
         for (size_t len = 2; len <= N; len <<= 1) {
-            double angle = 2 * RadarConfig::PI / len * (inverse ? -1 : 1);
-            std::complex<double> wlen(cos(angle), sin(angle));
+            const size_t half = len / 2;
+            const std::complex<T>* w = &twiddles[half - 1];
+#if RSP_FFT_SIMD_X86
+            if (level >= SimdLevel::AVX512 && half >= avx512_width) {
+                simd::radix2_stage_avx512(rows, count, N, half, w);
+                continue;
+            }
+            if (level >= SimdLevel::AVX2 && half >= avx2_width) {
+                simd::radix2_stage_avx2(rows, count, N, half, w);
+                continue;
+            }
+#endif
             for (size_t i = 0; i < N; i += len) {
-                std::complex<double> w(1);
-                for (size_t j = 0; j < len / 2; ++j) {
-                    std::complex<double> u = data[i + j];
-                    std::complex<double> t = w * data[i + j + len / 2];
-                    data[i + j] = u + t;
-                    data[i + j + len / 2] = u - t;
-                    w *= wlen;
+                for (size_t j = 0; j < half; ++j) {
+                    const std::complex<T> wj = w[j];
+                    for (size_t r = 0; r < count; ++r) {
+                        std::complex<T>* data = rows[r];
+                        std::complex<T> u = data[i + j];
+                        std::complex<T> t = wj * data[i + j + half];
+                        data[i + j] = u + t;
+                        data[i + j + half] = u - t;
+                    }
                 }
             }
         }
-        if (inverse) {
-            for (size_t i = 0; i < N; ++i) {
-                data[i] /= N; // Normalize the result
+    }
+
+    template <typename T>
+    void BasicFftPlan<T>::execute_radix4(std::complex<T>* const* rows, size_t count, bool inverse) const {
+        const size_t N = N_;
+        if (radix4_leading_radix2_) {
+            // Length-2 butterflies, all twiddles are 1
+            for (size_t r = 0; r < count; ++r) {
+                std::complex<T>* data = rows[r];
+                for (size_t i = 0; i < N; i += 2) {
+                    std::complex<T> u = data[i];
+                    std::complex<T> t = data[i + 1];
+                    data[i] = u + t;
+                    data[i + 1] = u - t;
+                }
+            }
+        }
+        // Multiplication by j (forward, e^(+j) kernel) or -j (inverse)
+        const T rot = inverse ? T(-1) : T(1);
+        const std::vector<std::complex<T>>& twiddles = inverse ? inverse_radix4_twiddles_ : forward_radix4_twiddles_;
+        const SimdLevel level = get_simd_level();
+        constexpr size_t avx2_width = 32 / sizeof(std::complex<T>);
+        constexpr size_t avx512_width = 64 / sizeof(std::complex<T>);
+        for (const Radix4Stage& stage : radix4_stages_) {
+            const size_t m = stage.m;
+            if (m == 1) {
+                // Length-4 codelet, all twiddles are 1
+                for (size_t r = 0; r < count; ++r) {
+                    std::complex<T>* data = rows[r];
+                    for (size_t i = 0; i < N; i += 4) {
+                        std::complex<T> t0 = data[i] + data[i + 1];
+                        std::complex<T> t1 = data[i] - data[i + 1];
+                        std::complex<T> t2 = data[i + 2] + data[i + 3];
+                        std::complex<T> t3 = data[i + 2] - data[i + 3];
+                        std::complex<T> jt3(-rot * t3.imag(), rot * t3.real());
+                        data[i] = t0 + t2;
+                        data[i + 1] = t1 + jt3;
+                        data[i + 2] = t0 - t2;
+                        data[i + 3] = t1 - jt3;
+                    }
+                }
+                continue;
+            }
+            const std::complex<T>* w1 = &twiddles[stage.offset];
+            const std::complex<T>* w2 = w1 + m;
+            const std::complex<T>* w3 = w2 + m;
+#if RSP_FFT_SIMD_X86
+            if (level >= SimdLevel::AVX512 && m >= avx512_width) {
+                simd::radix4_stage_avx512(rows, count, N, m, w1, w2, w3, inverse);
+                continue;
+            }
+            if (level >= SimdLevel::AVX2 && m >= avx2_width) {
+                simd::radix4_stage_avx2(rows, count, N, m, w1, w2, w3, inverse);
+                continue;
+            }
+#endif
+            for (size_t i = 0; i < N; i += 4 * m) {
+                for (size_t k = 0; k < m; ++k) {
+                    const std::complex<T> w1k = w1[k];
+                    const std::complex<T> w2k = w2[k];
+                    const std::complex<T> w3k = w3[k];
+                    for (size_t r = 0; r < count; ++r) {
+                        std::complex<T>* x0 = rows[r] + i;
+                        std::complex<T>* x1 = x0 + m;
+                        std::complex<T>* x2 = x1 + m;
+                        std::complex<T>* x3 = x2 + m;
+                        std::complex<T> a = x0[k];
+                        std::complex<T> b = w2k * x1[k]; // x[4n+2] sub-transform
+                        std::complex<T> c = w1k * x2[k]; // x[4n+1] sub-transform
+                        std::complex<T> d = w3k * x3[k]; // x[4n+3] sub-transform
+                        std::complex<T> t0 = a + b;
+                        std::complex<T> t1 = a - b;
+                        std::complex<T> t2 = c + d;
+                        std::complex<T> t3 = c - d;
+                        std::complex<T> jt3(-rot * t3.imag(), rot * t3.real());
+                        x0[k] = t0 + t2;
+                        x1[k] = t1 + jt3;
+                        x2[k] = t0 - t2;
+                        x3[k] = t1 - jt3;
+                    }
+                }
+            }
+        }
+    }
+
+    namespace {
+        std::atomic<RadarConfig::FftEngine> selectedEngine(RadarConfig::Config().fft_engine);
+    }
+
+    void set_fft_engine(RadarConfig::FftEngine engine) {
+        selectedEngine.store(engine, std::memory_order_relaxed);
+    }
+
+    RadarConfig::FftEngine get_fft_engine() {
+        return selectedEngine.load(std::memory_order_relaxed);
+    }
+
+    template <typename T>
+    const BasicFftPlan<T>& get_fft_plan(size_t N) {
+        static std::mutex plansMutex;
+        static std::map<size_t, std::unique_ptr<BasicFftPlan<T>>> plans;
+        std::lock_guard<std::mutex> lock(plansMutex);
+        std::unique_ptr<BasicFftPlan<T>>& plan = plans[N];
+        if (!plan) {
+            plan = std::make_unique<BasicFftPlan<T>>(N);
+        }
+        return *plan;
+    }
+
+    // Iterative FFT implementation
+    void fft(std::vector<std::complex<double>>& data, bool inverse) {
+        get_fft_plan(data.size()).execute(data.data(), inverse);
+    }
+
+    // Iterative FFT implementation on a contiguous buffer of N elements
+    void fft(std::complex<double>* data, size_t N, bool inverse) {
+        get_fft_plan(N).execute(data, inverse);
+    }
+
+    // Batched FFT: element n of transform b is data[b * dist + n * stride]
+    void fft_batch(std::complex<double>* data, size_t N, size_t howmany, size_t stride, size_t dist, bool inverse) {
+        get_fft_plan(N).execute_batch(data, howmany, stride, dist, inverse);
+    }
+
+    namespace {
+        // Forward transform of every sample row whose imaginary parts are all zero
+        template <typename T>
+        void transform_real_sample_rows(RadarData::BasicRadarCube<T>& frame, const BasicFftPlan<T>& plan) {
+            const size_t num_receivers = frame.num_receivers();
+            const size_t num_chirps = frame.num_chirps();
+            if (frame.receiver_stride() == num_chirps * frame.chirp_stride()) {
+                plan.execute_real_batch(frame.data(), num_receivers * num_chirps, frame.sample_stride(), frame.chirp_stride());
+                return;
+            }
+            for (size_t r = 0; r < num_receivers; r++) {
+                plan.execute_real_batch(&frame(static_cast<int>(r), 0, 0), num_chirps, frame.sample_stride(), frame.chirp_stride());
+            }
+        }
+
+        // Run the plan over every (receiver, chirp) sample row of the cube as one batch
+        template <typename T>
+        void transform_sample_rows(RadarData::BasicRadarCube<T>& frame, const BasicFftPlan<T>& plan, bool inverse) {
+            const size_t num_receivers = frame.num_receivers();
+            const size_t num_chirps = frame.num_chirps();
+            if (frame.receiver_stride() == num_chirps * frame.chirp_stride()) {
+                plan.execute_batch(frame.data(), num_receivers * num_chirps, frame.sample_stride(), frame.chirp_stride(), inverse);
+                return;
+            }
+            for (size_t r = 0; r < num_receivers; r++) {
+                plan.execute_batch(&frame(static_cast<int>(r), 0, 0), num_chirps, frame.sample_stride(), frame.chirp_stride(), inverse);
+            }
+        }
+
+        // Hilbert transform from the forward spectrum of every chirp: keep the one-sided
+        // spectrum and return to the time domain
+        template <typename T>
+        void hilbert_from_spectrum(RadarData::BasicRadarCube<T>& frame, const BasicFftPlan<T>& plan) {
+            const int num_receivers = frame.num_receivers();
+            const int num_chirps = frame.num_chirps();
+            const int num_samples = frame.num_samples();
+            // Apply Hilbert transform in frequency domain
+            for (int r = 0; r < num_receivers; r++) {
+                for (int c = 0; c < num_chirps; c++) {
+                    RadarData::StridedSpan<std::complex<T>> row = frame.samples(r, c);
+                    for (int s = 1; s < num_samples / 2; s++) {
+                        row[s] *= 2; // Double the amplitude of the positive frequencies
+                    }
+                    for (int s = num_samples / 2; s < num_samples; s++) {
+                        row[s] = 0; // Set the negative frequencies to zero
+                    }
+                }
+            }
+            transform_sample_rows(frame, plan, true); // Apply inverse FFT to get back to time domain
+        }
+
+        // Range profile of the fused Hilbert + FFT1 stage from the forward spectrum of
+        // every chirp
+        template <typename T>
+        void range_profile_from_spectrum(RadarData::BasicRadarCube<T>& frame) {
+            const int num_receivers = frame.num_receivers();
+            const int num_chirps = frame.num_chirps();
+            const size_t num_samples = frame.num_samples();
+            const T dc_scale = T(1) / static_cast<T>(num_samples);
+            const T positive_scale = T(2) / static_cast<T>(num_samples);
+            const size_t half = num_samples / 2;
+            for (int r = 0; r < num_receivers; r++) {
+                for (int c = 0; c < num_chirps; c++) {
+                    RadarData::StridedSpan<std::complex<T>> row = frame.samples(r, c);
+                    row[0] *= dc_scale;
+                    for (size_t k = 1; k < half; k++) {
+                        row[num_samples - k] = row[k] * positive_scale;
+                        row[k] = 0;
+                    }
+                    // Bounded by the row as well: for N == 1 half is 0 and N - half == N
+                    for (size_t k = half; k <= num_samples - half && k < num_samples; k++) {
+                        row[k] = 0;
+                    }
+                }
             }
         }
     }
 
     // Apply Hilbert transform to the samples dimension
-    void apply_hilbert_transform_samples(RadarData::Frame& frame) {
-        size_t num_receivers = frame.size();
-        size_t num_chirps = frame[0].size();
-        size_t num_samples = frame[0][0].size();
+    template <typename T>
+    void apply_hilbert_transform_samples(RadarData::BasicRadarCube<T>& frame, bool real_input) {
+        size_t num_receivers = frame.num_receivers();
+        size_t num_chirps = frame.num_chirps();
+        size_t num_samples = frame.num_samples();
         // Check if the frame is empty
         if (num_receivers == 0 || num_chirps == 0 || num_samples == 0) {
             std::cout << "Frame is empty, nothing to process." << std::endl;
             return; // Nothing to process
         }
-        for (int r = 0; r < num_receivers; r++) {
-            for (int c = 0; c < num_chirps; c++) {
-                std::vector<std::complex<double>> data(num_samples);
-                // Copy data to data vector by converting each sample to complex with imaginary part 0
-                for (int s = 0; s < num_samples; s++) {
-                    data[s] = frame[r][c][s]; // Already complex with imaginary part 0
-                }
-                // Apply FFT to the data vector to get frequency domain representation
-                fft(data, false);
-                // Apply Hilbert transform in frequency domain
-                for (int s = 1; s < num_samples / 2; s++) {
-                    data[s] *= 2; // Double the amplitude of the positive frequencies
-                }
-                for (int s = num_samples / 2; s < num_samples; s++) {
-                    data[s] = 0; // Set the negative frequencies to zero
-                }
-                fft(data, true); // Apply inverse FFT to get back to time domain
-                // Copy the data back to the frame
-                for (int s = 0; s < num_samples; s++) {
-                    frame[r][c][s] = data[s]; // Copy the complex value back to the frame
-                }
-            }
+        const BasicFftPlan<T>& plan = get_fft_plan<T>(num_samples);
+        // Apply FFT to every chirp to get frequency domain representation
+        if (real_input) {
+            transform_real_sample_rows(frame, plan);
+        }
+        else {
+            transform_sample_rows(frame, plan, false);
         }
+        hilbert_from_spectrum(frame, plan);
     }
 
   
 
     // Apply FFT1 to the frame
-    void apply_fft1(RadarData::Frame& frame) {
-        int num_receivers = frame.size();
-        int num_chirps = frame[0].size();
-        int num_samples = frame[0][0].size();
+    template <typename T>
+    void apply_fft1(RadarData::BasicRadarCube<T>& frame) {
+        int num_receivers = frame.num_receivers();
+        int num_chirps = frame.num_chirps();
+        int num_samples = frame.num_samples();
         // Check if the frame is empty
         if (num_receivers == 0 || num_chirps == 0 || num_samples == 0) {
             std::cout << "Frame is empty, nothing to process." << std::endl;
             return; // Nothing to process
         }
-        for (int r = 0; r < num_receivers; r++) {
-            for (int c = 0; c < num_chirps; c++) {
-                // Perform FFT directly on the frame data
-                std::vector<std::complex<double>>& data = frame[r][c];
-                fft(data, true); // Apply FFT to the data vector
+        // Perform FFT directly on the frame data, all chirps of all receivers in one batch
+        transform_sample_rows(frame, get_fft_plan<T>(num_samples), true);
+    }
+
+    // Apply the fused Hilbert + FFT1 stage to the frame. With X the forward FFT of a
+    // chirp, the three-pass path yields y[0] = X[0]/N, y[N-k] = 2*X[k]/N for
+    // 0 < k < N/2 and zero elsewhere.
+    template <typename T>
+    void apply_fused_range_fft(RadarData::BasicRadarCube<T>& frame, bool real_input) {
+        size_t num_receivers = frame.num_receivers();
+        size_t num_chirps = frame.num_chirps();
+        size_t num_samples = frame.num_samples();
+        // Check if the frame is empty
+        if (num_receivers == 0 || num_chirps == 0 || num_samples == 0) {
+            std::cout << "Frame is empty, nothing to process." << std::endl;
+            return; // Nothing to process
+        }
+        const BasicFftPlan<T>& plan = get_fft_plan<T>(num_samples);
+        if (real_input) {
+            transform_real_sample_rows(frame, plan);
+        }
+        else {
+            transform_sample_rows(frame, plan, false);
+        }
+
+        range_profile_from_spectrum(frame);
+    }
+
+    // Range stage straight from raw int16 samples. Pairs of chirps are converted
+    // (with optional DC removal and range window) directly into packed complex rows,
+    // so the widened input never exists as a cube; the spectra land in 'frame'.
+    template <typename T>
+    void apply_range_fft_raw(const RadarData::RawFrame& raw, RadarData::BasicRadarCube<T>& frame,
+        const RadarConfig::Config& config) {
+        const int num_receivers = raw.num_receivers();
+        const int num_chirps = raw.num_chirps();
+        const size_t num_samples = raw.num_samples();
+        // Check if the frame is empty
+        if (raw.empty()) {
+            std::cout << "Frame is empty, nothing to process." << std::endl;
+            return; // Nothing to process
+        }
+        // Every element is written below, so the cube is not cleared
+        frame.reshape(num_receivers, num_chirps, static_cast<int>(num_samples), RadarData::CubeLayout::ReceiverChirpSample);
+        const BasicFftPlan<T>& plan = get_fft_plan<T>(num_samples);
+
+        std::vector<T> window;
+        if (config.range_window) {
+            window.resize(num_samples);
+            for (size_t n = 0; n < num_samples; ++n) {
+                window[n] = static_cast<T>(0.5 * (1 - cos(2 * RadarConfig::PI * static_cast<double>(n) / static_cast<double>(num_samples - 1))));
+            }
+        }
+        // Convert one chirp to T, writing every value to out[n * 2] (interleaving
+        // lets two chirps share one complex row)
+        auto load_chirp = [&](int row, T* out) {
+            const int16_t* samples = raw.samples(row / num_chirps, row % num_chirps);
+            T offset = 0;
+            if (config.range_dc_removal) {
+                int64_t sum = 0;
+                for (size_t n = 0; n < num_samples; ++n) {
+                    sum += samples[n];
+                }
+                offset = static_cast<T>(static_cast<double>(sum) / static_cast<double>(num_samples));
+            }
+            if (window.empty()) {
+                for (size_t n = 0; n < num_samples; ++n) {
+                    out[2 * n] = static_cast<T>(samples[n]) - offset;
+                }
             }
+            else {
+                for (size_t n = 0; n < num_samples; ++n) {
+                    out[2 * n] = (static_cast<T>(samples[n]) - offset) * window[n];
+                }
+            }
+        };
+        auto frame_row = [&](int row) {
+            return &frame(row / num_chirps, row % num_chirps, 0);
+        };
+
+        const int num_rows = num_receivers * num_chirps;
+        const size_t pairs = static_cast<size_t>(num_rows / 2);
+        std::complex<T>* packed[FFT_BATCH_ROWS];
+        std::complex<T>* out_a[FFT_BATCH_ROWS];
+        std::complex<T>* out_b[FFT_BATCH_ROWS];
+        thread_local std::vector<std::complex<T>> scratch;
+        scratch.resize(FFT_BATCH_ROWS * num_samples);
+        for (size_t first = 0; first < pairs; first += FFT_BATCH_ROWS) {
+            size_t count = std::min(FFT_BATCH_ROWS, pairs - first);
+            for (size_t p = 0; p < count; ++p) {
+                int row = static_cast<int>(2 * (first + p));
+                packed[p] = &scratch[p * num_samples];
+                T* values = reinterpret_cast<T*>(packed[p]);
+                load_chirp(row, values);     // Real parts
+                load_chirp(row + 1, values + 1); // Imaginary parts
+                out_a[p] = frame_row(row);
+                out_b[p] = frame_row(row + 1);
+            }
+            plan.execute_packed_real(packed, count, out_a, out_b, 1);
+        }
+        if (num_rows % 2 != 0) {
+            // Odd chirp out goes through the complex transform
+            std::complex<T>* last = frame_row(num_rows - 1);
+            T* values = reinterpret_cast<T*>(last);
+            load_chirp(num_rows - 1, values);
+            for (size_t n = 0; n < num_samples; ++n) {
+                values[2 * n + 1] = 0;
+            }
+            plan.execute(last, false);
+        }
+
+        if (config.fused_range_fft) {
+            range_profile_from_spectrum(frame);
+        }
+        else {
+            hilbert_from_spectrum(frame, plan);
+            apply_fft1(frame);
         }
     }
 
@@ -114,30 +615,75 @@ namespace fftProcessing {
             data[i] /= fft_length;
         }
     }
-    // Apply FFT2 to the frame
-    void apply_fft2(RadarData::Frame& frame) {
-        size_t num_receivers = frame.size();
-        size_t num_chirps = frame[0].size();
-        size_t num_samples = frame[0][0].size();
+    // Apply FFT2 to the frame. Strips of DOPPLER_TILE_SAMPLES range bins are transposed
+    // (and windowed) into chirp-contiguous rows, transformed as one batch and written
+    // back, instead of gathering one strided chirp column at a time.
+    template <typename T>
+    void apply_fft2(RadarData::BasicRadarCube<T>& frame, bool doppler_major_output) {
+        size_t num_receivers = frame.num_receivers();
+        size_t num_chirps = frame.num_chirps();
+        size_t num_samples = frame.num_samples();
         // Check if the frame is empty
         if (num_receivers == 0 || num_chirps == 0 || num_samples == 0) {
             std::cout << "Frame is empty, nothing to process." << std::endl;
             return; // Nothing to process
         }
 
-        for (int r = 0; r < num_receivers; r++) {
-            for (int s = 0; s < num_samples; s++) {
-                std::vector<std::complex<double>> data(num_chirps);
-                // Copy data to data vector by converting each sample to complex with imaginary part 0
-                for (int c = 0; c < num_chirps; c++) {
-                    data[c] = frame[r][c][s]; // Already complex with imaginary part 0
+        const BasicFftPlan<T>& plan = get_fft_plan<T>(num_chirps);
+        // Hanning window over the chirps, same values as apply_hanning_window
+        std::vector<T> window(num_chirps);
+        for (size_t n = 0; n < num_chirps; ++n) {
+            window[n] = static_cast<T>(0.5 * (1 - cos(2 * RadarConfig::PI * static_cast<double>(n) / static_cast<double>(num_chirps - 1))));
+        }
+        const T fft_length = static_cast<T>(num_chirps);
+        const size_t sample_stride = frame.sample_stride();
+
+        // Copy samples [s0, s0 + count) of every chirp into rows of 'dst' (row t holds
+        // sample s0 + t across all chirps, rows 'dist' apart), applying the window
+        auto transpose_in = [&](int r, size_t s0, size_t count, std::complex<T>* dst, size_t dist) {
+            for (size_t c = 0; c < num_chirps; c++) {
+                const std::complex<T>* src = &frame(r, static_cast<int>(c), static_cast<int>(s0));
+                const T w = window[c];
+                for (size_t t = 0; t < count; t++) {
+                    dst[t * dist + c] = src[t * sample_stride] * w;
                 }
-                // Apply Hanning window
-                apply_hanning_window(data);
-                fft(data, false); // Apply FFT to the data vector
-                normalize_fft_output(data, num_chirps);
-                for (int c = 0; c < num_chirps; c++) {
-                    frame[r][c][s] = data[c]; // Copy the complex value back to the frame
+            }
+        };
+
+        if (doppler_major_output) {
+            // Transpose into an R x S x C cube, transform it in place and hand it to the
+            // caller; the previous buffer is kept for the next frame
+            thread_local RadarData::BasicRadarCube<T> dopplerMajor;
+            dopplerMajor.reshape(static_cast<int>(num_receivers), static_cast<int>(num_chirps),
+                static_cast<int>(num_samples), RadarData::CubeLayout::ReceiverSampleChirp);
+            for (size_t r = 0; r < num_receivers; r++) {
+                for (size_t s0 = 0; s0 < num_samples; s0 += DOPPLER_TILE_SAMPLES) {
+                    size_t count = std::min(DOPPLER_TILE_SAMPLES, num_samples - s0);
+                    transpose_in(r, s0, count, &dopplerMajor(r, 0, static_cast<int>(s0)), num_chirps);
+                }
+            }
+            plan.execute_batch(dopplerMajor.data(), num_receivers * num_samples, 1, num_chirps, false);
+            std::complex<T>* data = dopplerMajor.data();
+            for (size_t i = 0; i < dopplerMajor.size(); i++) {
+                data[i] /= fft_length;
+            }
+            frame.swap(dopplerMajor);
+            return;
+        }
+
+        thread_local std::vector<std::complex<T>> tile;
+        tile.resize(DOPPLER_TILE_SAMPLES * num_chirps);
+        for (size_t r = 0; r < num_receivers; r++) {
+            for (size_t s0 = 0; s0 < num_samples; s0 += DOPPLER_TILE_SAMPLES) {
+                size_t count = std::min(DOPPLER_TILE_SAMPLES, num_samples - s0);
+                transpose_in(r, s0, count, tile.data(), num_chirps);
+                plan.execute_batch(tile.data(), count, 1, num_chirps, false);
+                // Normalize while transposing back into the frame
+                for (size_t c = 0; c < num_chirps; c++) {
+                    std::complex<T>* dst = &frame(r, static_cast<int>(c), static_cast<int>(s0));
+                    for (size_t t = 0; t < count; t++) {
+                        dst[t * sample_stride] = tile[t * num_chirps + c] / fft_length;
+                    }
                 }
             }
         }
@@ -145,12 +691,54 @@ namespace fftProcessing {
 
     // Function to process the frame with Hilbert transform, FFT1, and FFT2
     void fftProcessPipeline(RadarData::Frame& frame) {
-        // Apply Hilbert transform on the sample dimension
-        apply_hilbert_transform_samples(frame);
-        
-        // Apply FFT1 on the sample dimension
-        apply_fft1(frame);
+        fftProcessPipeline(frame, RadarConfig::Config());
+    }
+
+    template <typename T>
+    void fftProcessPipeline(RadarData::BasicRadarCube<T>& frame, const RadarConfig::Config& config) {
+        if (config.fused_range_fft) {
+            // Hilbert transform and FFT1 as one forward FFT on the sample dimension
+            apply_fused_range_fft(frame, config.real_adc_input);
+        }
+        else {
+            // Apply Hilbert transform on the sample dimension
+            apply_hilbert_transform_samples(frame, config.real_adc_input);
+
+            // Apply FFT1 on the sample dimension
+            apply_fft1(frame);
+        }
         // Apply FFT2 on the chirp dimension
-        apply_fft2(frame);
+        apply_fft2(frame, config.doppler_major_output);
+    }
+
+    template <typename T>
+    void fftProcessPipeline(const RadarData::RawFrame& raw, RadarData::BasicRadarCube<T>& frame,
+        const RadarConfig::Config& config) {
+        // Hilbert transform and FFT1 from the raw samples, then FFT2 on the chirp dimension
+        apply_range_fft_raw(raw, frame, config);
+        apply_fft2(frame, config.doppler_major_output);
     }
+
+    template class BasicFftPlan<float>;
+    template class BasicFftPlan<double>;
+    template const BasicFftPlan<float>& get_fft_plan<float>(size_t N);
+    template const BasicFftPlan<double>& get_fft_plan<double>(size_t N);
+    template void apply_hilbert_transform_samples<float>(RadarData::FrameF& frame, bool real_input);
+    template void apply_hilbert_transform_samples<double>(RadarData::Frame& frame, bool real_input);
+    template void apply_fft1<float>(RadarData::FrameF& frame);
+    template void apply_fft1<double>(RadarData::Frame& frame);
+    template void apply_fused_range_fft<float>(RadarData::FrameF& frame, bool real_input);
+    template void apply_fused_range_fft<double>(RadarData::Frame& frame, bool real_input);
+    template void apply_fft2<float>(RadarData::FrameF& frame, bool doppler_major_output);
+    template void apply_fft2<double>(RadarData::Frame& frame, bool doppler_major_output);
+    template void fftProcessPipeline<float>(RadarData::FrameF& frame, const RadarConfig::Config& config);
+    template void fftProcessPipeline<double>(RadarData::Frame& frame, const RadarConfig::Config& config);
+    template void apply_range_fft_raw<float>(const RadarData::RawFrame& raw, RadarData::FrameF& frame,
+        const RadarConfig::Config& config);
+    template void apply_range_fft_raw<double>(const RadarData::RawFrame& raw, RadarData::Frame& frame,
+        const RadarConfig::Config& config);
+    template void fftProcessPipeline<float>(const RadarData::RawFrame& raw, RadarData::FrameF& frame,
+        const RadarConfig::Config& config);
+    template void fftProcessPipeline<double>(const RadarData::RawFrame& raw, RadarData::Frame& frame,
+        const RadarConfig::Config& config);
 }
@@ -1,15 +1,107 @@
 #ifndef FFT_PROCESSING_H
 #define FFT_PROCESSING_H
 
+#include <cstdint>
+#include <utility>
+#include <vector>
 #include "datatypes.hpp"
+#include "config.hpp"
 
 namespace fftProcessing
 {
-	void apply_hilbert_transform_samples(RadarData::Frame& frame);
-	void apply_fft1(RadarData::Frame& frame);
-	void apply_fft2(RadarData::Frame& frame);
+	// Number of rows a batched transform works on together
+	constexpr size_t FFT_BATCH_ROWS = 4;
+	// Range bins transposed together by the Doppler stage
+	constexpr size_t DOPPLER_TILE_SAMPLES = 16;
+
+	// Precomputed FFT for one power-of-two length: bit-reversal swap list, per-stage
+	// radix-2 twiddle tables and radix-4 twiddle tables. Built once per length and
+	// shared by all transforms. Instantiated for float and double samples.
+	template <typename T>
+	class BasicFftPlan {
+	public:
+		explicit BasicFftPlan(size_t N);
+		size_t size() const { return N_; }
+		// In-place transform of N contiguous elements with the selected engine;
+		// the inverse is scaled by 1/N
+		void execute(std::complex<T>* data, bool inverse = false) const;
+		void execute(std::complex<T>* data, bool inverse, RadarConfig::FftEngine engine) const;
+		// 'howmany' transforms; element n of transform b is data[b * dist + n * stride]
+		void execute_batch(std::complex<T>* data, size_t howmany, size_t stride, size_t dist, bool inverse = false) const;
+		// Forward transform of 'howmany' rows laid out as in execute_batch whose imaginary
+		// parts are all zero. Rows are packed two per complex transform, halving the work;
+		// on return each row holds its full complex spectrum.
+		void execute_real_batch(std::complex<T>* data, size_t howmany, size_t stride, size_t dist) const;
+		// Forward transform of 'count' contiguous rows each packing two real signals as
+		// a + jb, followed by the split into the spectra of a and b, written to out_a
+		// and out_b with the given element stride. out_a may alias the packed rows when
+		// the stride is 1.
+		void execute_packed_real(std::complex<T>* const* packed, size_t count,
+			std::complex<T>* const* out_a, std::complex<T>* const* out_b, size_t stride) const;
+
+	private:
+		void execute_rows(std::complex<T>* const* rows, size_t count, bool inverse, RadarConfig::FftEngine engine) const;
+		void execute_radix2(std::complex<T>* const* rows, size_t count, bool inverse) const;
+		void execute_radix4(std::complex<T>* const* rows, size_t count, bool inverse) const;
+
+		// Radix-4 stage combining four sub-transforms of length m
+		struct Radix4Stage {
+			size_t m;
+			size_t offset; // Start of this stage's w^k, w^2k and w^3k tables (m entries each)
+		};
+
+		size_t N_;
+		std::vector<std::pair<uint32_t, uint32_t>> swaps_;
+		std::vector<std::complex<T>> forward_twiddles_;
+		std::vector<std::complex<T>> inverse_twiddles_;
+		bool radix4_leading_radix2_ = false; // log2(N) odd: one radix-2 stage first
+		std::vector<Radix4Stage> radix4_stages_;
+		std::vector<std::complex<T>> forward_radix4_twiddles_;
+		std::vector<std::complex<T>> inverse_radix4_twiddles_;
+	};
+
+	using FftPlan = BasicFftPlan<double>;
+	using FftPlanF = BasicFftPlan<float>;
+
+	// Engine used by fft() and FftPlan::execute(data, inverse)
+	void set_fft_engine(RadarConfig::FftEngine engine);
+	RadarConfig::FftEngine get_fft_engine();
+
+	// Cached plan for length N and sample type T, created on first use
+	template <typename T = double>
+	const BasicFftPlan<T>& get_fft_plan(size_t N);
+
+	// Frame stages, instantiated for Frame (double) and FrameF (float).
+	// real_input: every sample has a zero imaginary part (raw ADC data), so the forward
+	// FFT can use FftPlan::execute_real_batch
+	template <typename T>
+	void apply_hilbert_transform_samples(RadarData::BasicRadarCube<T>& frame, bool real_input = false);
+	template <typename T>
+	void apply_fft1(RadarData::BasicRadarCube<T>& frame);
+	// Hilbert transform followed by FFT1 in a single forward FFT per chirp. The two
+	// inverse transforms of the three-pass path cancel to an index reversal, so the
+	// range profile is read straight from the one-sided spectrum.
+	template <typename T>
+	void apply_fused_range_fft(RadarData::BasicRadarCube<T>& frame, bool real_input = false);
+	// Hilbert transform and FFT1 (fused or three-pass, per config) computed straight
+	// from raw int16 samples into 'frame', with optional DC removal and range window
+	// applied while the samples are converted
+	template <typename T>
+	void apply_range_fft_raw(const RadarData::RawFrame& raw, RadarData::BasicRadarCube<T>& frame,
+		const RadarConfig::Config& config);
+	// Doppler FFT over the chirps of every (receiver, sample). With doppler_major_output
+	// the frame is left in ReceiverSampleChirp layout, skipping the transpose back.
+	template <typename T>
+	void apply_fft2(RadarData::BasicRadarCube<T>& frame, bool doppler_major_output = false);
 	void fft(std::vector<std::complex<double>>& data, bool inverse = false);
+	void fft(std::complex<double>* data, size_t N, bool inverse = false);
+	void fft_batch(std::complex<double>* data, size_t N, size_t howmany, size_t stride, size_t dist, bool inverse = false);
 	void fftProcessPipeline(RadarData::Frame& frame);
+	template <typename T>
+	void fftProcessPipeline(RadarData::BasicRadarCube<T>& frame, const RadarConfig::Config& config);
+	template <typename T>
+	void fftProcessPipeline(const RadarData::RawFrame& raw, RadarData::BasicRadarCube<T>& frame,
+		const RadarConfig::Config& config);
 	void apply_hanning_window(std::vector<std::complex<double>>& data);
 	void normalize_fft_output(std::vector<std::complex<double>>& data, size_t fft_length);
 }
@@ -0,0 +1,366 @@
+#include "fft_simd.hpp"
+#include <atomic>
+
+#if RSP_FFT_SIMD_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+// MSVC accepts the intrinsics in any function; GCC and Clang need the target
+// enabled per function so the rest of the program stays baseline x86-64
+#if defined(_MSC_VER) && !defined(__clang__)
+#define RSP_TARGET_AVX2
+#define RSP_TARGET_AVX512
+#else
+#define RSP_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define RSP_TARGET_AVX512 __attribute__((target("avx512f")))
+#endif
+
+namespace fftProcessing {
+    namespace {
+#if RSP_FFT_SIMD_X86
+        void cpuid(int leaf, int subleaf, unsigned int regs[4]) {
+#if defined(_MSC_VER)
+            int info[4];
+            __cpuidex(info, leaf, subleaf);
+            for (int i = 0; i < 4; ++i) regs[i] = static_cast<unsigned int>(info[i]);
+#else
+            __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+        }
+
+        unsigned long long xgetbv0() {
+#if defined(_MSC_VER)
+            return _xgetbv(0);
+#else
+            unsigned int eax, edx;
+            __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+            return (static_cast<unsigned long long>(edx) << 32) | eax;
+#endif
+        }
+#endif
+
+        SimdLevel query_simd_level() {
+#if RSP_FFT_SIMD_X86
+            unsigned int regs[4];
+            cpuid(0, 0, regs);
+            if (regs[0] < 7) {
+                return SimdLevel::Scalar;
+            }
+            cpuid(1, 0, regs);
+            bool osxsave = (regs[2] & (1u << 27)) != 0;
+            bool avx = (regs[2] & (1u << 28)) != 0;
+            bool fma = (regs[2] & (1u << 12)) != 0;
+            if (!osxsave || !avx) {
+                return SimdLevel::Scalar;
+            }
+            // The OS must save the YMM (and for AVX-512 the opmask/ZMM) state
+            unsigned long long xcr0 = xgetbv0();
+            bool ymmState = (xcr0 & 0x6) == 0x6;
+            bool zmmState = (xcr0 & 0xE6) == 0xE6;
+            cpuid(7, 0, regs);
+            bool avx2 = (regs[1] & (1u << 5)) != 0;
+            bool avx512f = (regs[1] & (1u << 16)) != 0;
+            if (avx512f && fma && zmmState) {
+                return SimdLevel::AVX512;
+            }
+            if (avx2 && fma && ymmState) {
+                return SimdLevel::AVX2;
+            }
+#endif
+            return SimdLevel::Scalar;
+        }
+
+        std::atomic<int> selectedLevel(-1);
+    }
+
+    SimdLevel detect_simd_level() {
+        static const SimdLevel detected = query_simd_level();
+        return detected;
+    }
+
+    void set_simd_level(SimdLevel level) {
+        if (level > detect_simd_level()) {
+            level = detect_simd_level();
+        }
+        selectedLevel.store(static_cast<int>(level), std::memory_order_relaxed);
+    }
+
+    SimdLevel get_simd_level() {
+        int level = selectedLevel.load(std::memory_order_relaxed);
+        return level < 0 ? detect_simd_level() : static_cast<SimdLevel>(level);
+    }
+
+    const char* simd_level_name(SimdLevel level) {
+        switch (level) {
+        case SimdLevel::AVX2: return "AVX2";
+        case SimdLevel::AVX512: return "AVX-512";
+        default: return "scalar";
+        }
+    }
+
+#if RSP_FFT_SIMD_X86
+    namespace simd {
+        namespace {
+            // Complex multiply of interleaved (re, im) pairs
+            RSP_TARGET_AVX2 inline __m256d cmul(__m256d a, __m256d w) {
+                __m256d wr = _mm256_movedup_pd(w);                      // (wr, wr)
+                __m256d wi = _mm256_permute_pd(w, 0xF);                 // (wi, wi)
+                __m256d swapped = _mm256_permute_pd(a, 0x5);            // (im, re)
+                return _mm256_fmaddsub_pd(a, wr, _mm256_mul_pd(swapped, wi));
+            }
+
+            // Multiply by +j (sign = (-1, 1)) or -j (sign = (1, -1))
+            RSP_TARGET_AVX2 inline __m256d mul_j(__m256d a, __m256d sign) {
+                return _mm256_mul_pd(_mm256_permute_pd(a, 0x5), sign);
+            }
+
+            RSP_TARGET_AVX512 inline __m512d cmul(__m512d a, __m512d w) {
+                __m512d wr = _mm512_movedup_pd(w);
+                __m512d wi = _mm512_permute_pd(w, 0xFF);
+                __m512d swapped = _mm512_permute_pd(a, 0x55);
+                return _mm512_fmaddsub_pd(a, wr, _mm512_mul_pd(swapped, wi));
+            }
+
+            RSP_TARGET_AVX512 inline __m512d mul_j(__m512d a, __m512d sign) {
+                return _mm512_mul_pd(_mm512_permute_pd(a, 0x55), sign);
+            }
+
+            // Single-precision counterparts, 4 (AVX2) or 8 (AVX-512) complex values
+            RSP_TARGET_AVX2 inline __m256 cmul(__m256 a, __m256 w) {
+                __m256 wr = _mm256_moveldup_ps(w);
+                __m256 wi = _mm256_movehdup_ps(w);
+                __m256 swapped = _mm256_permute_ps(a, 0xB1);
+                return _mm256_fmaddsub_ps(a, wr, _mm256_mul_ps(swapped, wi));
+            }
+
+            RSP_TARGET_AVX2 inline __m256 mul_j(__m256 a, __m256 sign) {
+                return _mm256_mul_ps(_mm256_permute_ps(a, 0xB1), sign);
+            }
+
+            RSP_TARGET_AVX512 inline __m512 cmul(__m512 a, __m512 w) {
+                __m512 wr = _mm512_moveldup_ps(w);
+                __m512 wi = _mm512_movehdup_ps(w);
+                __m512 swapped = _mm512_permute_ps(a, 0xB1);
+                return _mm512_fmaddsub_ps(a, wr, _mm512_mul_ps(swapped, wi));
+            }
+
+            RSP_TARGET_AVX512 inline __m512 mul_j(__m512 a, __m512 sign) {
+                return _mm512_mul_ps(_mm512_permute_ps(a, 0xB1), sign);
+            }
+        }
+
+        RSP_TARGET_AVX2 void radix2_stage_avx2(std::complex<double>* const* rows, size_t count, size_t N, size_t half,
+            const std::complex<double>* w) {
+            const double* tw = reinterpret_cast<const double*>(w);
+            for (size_t i = 0; i < N; i += 2 * half) {
+                for (size_t j = 0; j < 2 * half; j += 4) {
+                    __m256d wj = _mm256_loadu_pd(tw + j);
+                    for (size_t r = 0; r < count; ++r) {
+                        double* lo = reinterpret_cast<double*>(rows[r] + i) + j;
+                        double* hi = lo + 2 * half;
+                        __m256d u = _mm256_loadu_pd(lo);
+                        __m256d t = cmul(_mm256_loadu_pd(hi), wj);
+                        _mm256_storeu_pd(lo, _mm256_add_pd(u, t));
+                        _mm256_storeu_pd(hi, _mm256_sub_pd(u, t));
+                    }
+                }
+            }
+        }
+
+        RSP_TARGET_AVX512 void radix2_stage_avx512(std::complex<double>* const* rows, size_t count, size_t N, size_t half,
+            const std::complex<double>* w) {
+            const double* tw = reinterpret_cast<const double*>(w);
+            for (size_t i = 0; i < N; i += 2 * half) {
+                for (size_t j = 0; j < 2 * half; j += 8) {
+                    __m512d wj = _mm512_loadu_pd(tw + j);
+                    for (size_t r = 0; r < count; ++r) {
+                        double* lo = reinterpret_cast<double*>(rows[r] + i) + j;
+                        double* hi = lo + 2 * half;
+                        __m512d u = _mm512_loadu_pd(lo);
+                        __m512d t = cmul(_mm512_loadu_pd(hi), wj);
+                        _mm512_storeu_pd(lo, _mm512_add_pd(u, t));
+                        _mm512_storeu_pd(hi, _mm512_sub_pd(u, t));
+                    }
+                }
+            }
+        }
+
+        RSP_TARGET_AVX2 void radix4_stage_avx2(std::complex<double>* const* rows, size_t count, size_t N, size_t m,
+            const std::complex<double>* w1, const std::complex<double>* w2, const std::complex<double>* w3, bool inverse) {
+            const double* tw1 = reinterpret_cast<const double*>(w1);
+            const double* tw2 = reinterpret_cast<const double*>(w2);
+            const double* tw3 = reinterpret_cast<const double*>(w3);
+            const __m256d sign = inverse ? _mm256_setr_pd(1.0, -1.0, 1.0, -1.0) : _mm256_setr_pd(-1.0, 1.0, -1.0, 1.0);
+            for (size_t i = 0; i < N; i += 4 * m) {
+                for (size_t k = 0; k < 2 * m; k += 4) {
+                    __m256d w1k = _mm256_loadu_pd(tw1 + k);
+                    __m256d w2k = _mm256_loadu_pd(tw2 + k);
+                    __m256d w3k = _mm256_loadu_pd(tw3 + k);
+                    for (size_t r = 0; r < count; ++r) {
+                        double* x0 = reinterpret_cast<double*>(rows[r] + i) + k;
+                        double* x1 = x0 + 2 * m;
+                        double* x2 = x1 + 2 * m;
+                        double* x3 = x2 + 2 * m;
+                        __m256d a = _mm256_loadu_pd(x0);
+                        __m256d b = cmul(_mm256_loadu_pd(x1), w2k);
+                        __m256d c = cmul(_mm256_loadu_pd(x2), w1k);
+                        __m256d d = cmul(_mm256_loadu_pd(x3), w3k);
+                        __m256d t0 = _mm256_add_pd(a, b);
+                        __m256d t1 = _mm256_sub_pd(a, b);
+                        __m256d t2 = _mm256_add_pd(c, d);
+                        __m256d jt3 = mul_j(_mm256_sub_pd(c, d), sign);
+                        _mm256_storeu_pd(x0, _mm256_add_pd(t0, t2));
+                        _mm256_storeu_pd(x1, _mm256_add_pd(t1, jt3));
+                        _mm256_storeu_pd(x2, _mm256_sub_pd(t0, t2));
+                        _mm256_storeu_pd(x3, _mm256_sub_pd(t1, jt3));
+                    }
+                }
+            }
+        }
+
+        RSP_TARGET_AVX512 void radix4_stage_avx512(std::complex<double>* const* rows, size_t count, size_t N, size_t m,
+            const std::complex<double>* w1, const std::complex<double>* w2, const std::complex<double>* w3, bool inverse) {
+            const double* tw1 = reinterpret_cast<const double*>(w1);
+            const double* tw2 = reinterpret_cast<const double*>(w2);
+            const double* tw3 = reinterpret_cast<const double*>(w3);
+            const __m512d sign = inverse ? _mm512_setr_pd(1.0, -1.0, 1.0, -1.0, 1.0, -1.0, 1.0, -1.0)
+                : _mm512_setr_pd(-1.0, 1.0, -1.0, 1.0, -1.0, 1.0, -1.0, 1.0);
+            for (size_t i = 0; i < N; i += 4 * m) {
+                for (size_t k = 0; k < 2 * m; k += 8) {
+                    __m512d w1k = _mm512_loadu_pd(tw1 + k);
+                    __m512d w2k = _mm512_loadu_pd(tw2 + k);
+                    __m512d w3k = _mm512_loadu_pd(tw3 + k);
+                    for (size_t r = 0; r < count; ++r) {
+                        double* x0 = reinterpret_cast<double*>(rows[r] + i) + k;
+                        double* x1 = x0 + 2 * m;
+                        double* x2 = x1 + 2 * m;
+                        double* x3 = x2 + 2 * m;
+                        __m512d a = _mm512_loadu_pd(x0);
+                        __m512d b = cmul(_mm512_loadu_pd(x1), w2k);
+                        __m512d c = cmul(_mm512_loadu_pd(x2), w1k);
+                        __m512d d = cmul(_mm512_loadu_pd(x3), w3k);
+                        __m512d t0 = _mm512_add_pd(a, b);
+                        __m512d t1 = _mm512_sub_pd(a, b);
+                        __m512d t2 = _mm512_add_pd(c, d);
+                        __m512d jt3 = mul_j(_mm512_sub_pd(c, d), sign);
+                        _mm512_storeu_pd(x0, _mm512_add_pd(t0, t2));
+                        _mm512_storeu_pd(x1, _mm512_add_pd(t1, jt3));
+                        _mm512_storeu_pd(x2, _mm512_sub_pd(t0, t2));
+                        _mm512_storeu_pd(x3, _mm512_sub_pd(t1, jt3));
+                    }
+                }
+            }
+        }
+
+        RSP_TARGET_AVX2 void radix2_stage_avx2(std::complex<float>* const* rows, size_t count, size_t N, size_t half,
+            const std::complex<float>* w) {
+            const float* tw = reinterpret_cast<const float*>(w);
+            for (size_t i = 0; i < N; i += 2 * half) {
+                for (size_t j = 0; j < 2 * half; j += 8) {
+                    __m256 wj = _mm256_loadu_ps(tw + j);
+                    for (size_t r = 0; r < count; ++r) {
+                        float* lo = reinterpret_cast<float*>(rows[r] + i) + j;
+                        float* hi = lo + 2 * half;
+                        __m256 u = _mm256_loadu_ps(lo);
+                        __m256 t = cmul(_mm256_loadu_ps(hi), wj);
+                        _mm256_storeu_ps(lo, _mm256_add_ps(u, t));
+                        _mm256_storeu_ps(hi, _mm256_sub_ps(u, t));
+                    }
+                }
+            }
+        }
+
+        RSP_TARGET_AVX512 void radix2_stage_avx512(std::complex<float>* const* rows, size_t count, size_t N, size_t half,
+            const std::complex<float>* w) {
+            const float* tw = reinterpret_cast<const float*>(w);
+            for (size_t i = 0; i < N; i += 2 * half) {
+                for (size_t j = 0; j < 2 * half; j += 16) {
+                    __m512 wj = _mm512_loadu_ps(tw + j);
+                    for (size_t r = 0; r < count; ++r) {
+                        float* lo = reinterpret_cast<float*>(rows[r] + i) + j;
+                        float* hi = lo + 2 * half;
+                        __m512 u = _mm512_loadu_ps(lo);
+                        __m512 t = cmul(_mm512_loadu_ps(hi), wj);
+                        _mm512_storeu_ps(lo, _mm512_add_ps(u, t));
+                        _mm512_storeu_ps(hi, _mm512_sub_ps(u, t));
+                    }
+                }
+            }
+        }
+
+        RSP_TARGET_AVX2 void radix4_stage_avx2(std::complex<float>* const* rows, size_t count, size_t N, size_t m,
+            const std::complex<float>* w1, const std::complex<float>* w2, const std::complex<float>* w3, bool inverse) {
+            const float* tw1 = reinterpret_cast<const float*>(w1);
+            const float* tw2 = reinterpret_cast<const float*>(w2);
+            const float* tw3 = reinterpret_cast<const float*>(w3);
+            const __m256 sign = inverse ? _mm256_setr_ps(1.0f, -1.0f, 1.0f, -1.0f, 1.0f, -1.0f, 1.0f, -1.0f)
+                : _mm256_setr_ps(-1.0f, 1.0f, -1.0f, 1.0f, -1.0f, 1.0f, -1.0f, 1.0f);
+            for (size_t i = 0; i < N; i += 4 * m) {
+                for (size_t k = 0; k < 2 * m; k += 8) {
+                    __m256 w1k = _mm256_loadu_ps(tw1 + k);
+                    __m256 w2k = _mm256_loadu_ps(tw2 + k);
+                    __m256 w3k = _mm256_loadu_ps(tw3 + k);
+                    for (size_t r = 0; r < count; ++r) {
+                        float* x0 = reinterpret_cast<float*>(rows[r] + i) + k;
+                        float* x1 = x0 + 2 * m;
+                        float* x2 = x1 + 2 * m;
+                        float* x3 = x2 + 2 * m;
+                        __m256 a = _mm256_loadu_ps(x0);
+                        __m256 b = cmul(_mm256_loadu_ps(x1), w2k);
+                        __m256 c = cmul(_mm256_loadu_ps(x2), w1k);
+                        __m256 d = cmul(_mm256_loadu_ps(x3), w3k);
+                        __m256 t0 = _mm256_add_ps(a, b);
+                        __m256 t1 = _mm256_sub_ps(a, b);
+                        __m256 t2 = _mm256_add_ps(c, d);
+                        __m256 jt3 = mul_j(_mm256_sub_ps(c, d), sign);
+                        _mm256_storeu_ps(x0, _mm256_add_ps(t0, t2));
+                        _mm256_storeu_ps(x1, _mm256_add_ps(t1, jt3));
+                        _mm256_storeu_ps(x2, _mm256_sub_ps(t0, t2));
+                        _mm256_storeu_ps(x3, _mm256_sub_ps(t1, jt3));
+                    }
+                }
+            }
+        }
+
+        RSP_TARGET_AVX512 void radix4_stage_avx512(std::complex<float>* const* rows, size_t count, size_t N, size_t m,
+            const std::complex<float>* w1, const std::complex<float>* w2, const std::complex<float>* w3, bool inverse) {
+            const float* tw1 = reinterpret_cast<const float*>(w1);
+            const float* tw2 = reinterpret_cast<const float*>(w2);
+            const float* tw3 = reinterpret_cast<const float*>(w3);
+            const __m512 sign = inverse
+                ? _mm512_setr_ps(1.0f, -1.0f, 1.0f, -1.0f, 1.0f, -1.0f, 1.0f, -1.0f, 1.0f, -1.0f, 1.0f, -1.0f, 1.0f, -1.0f, 1.0f, -1.0f)
+                : _mm512_setr_ps(-1.0f, 1.0f, -1.0f, 1.0f, -1.0f, 1.0f, -1.0f, 1.0f, -1.0f, 1.0f, -1.0f, 1.0f, -1.0f, 1.0f, -1.0f, 1.0f);
+            for (size_t i = 0; i < N; i += 4 * m) {
+                for (size_t k = 0; k < 2 * m; k += 16) {
+                    __m512 w1k = _mm512_loadu_ps(tw1 + k);
+                    __m512 w2k = _mm512_loadu_ps(tw2 + k);
+                    __m512 w3k = _mm512_loadu_ps(tw3 + k);
+                    for (size_t r = 0; r < count; ++r) {
+                        float* x0 = reinterpret_cast<float*>(rows[r] + i) + k;
+                        float* x1 = x0 + 2 * m;
+                        float* x2 = x1 + 2 * m;
+                        float* x3 = x2 + 2 * m;
+                        __m512 a = _mm512_loadu_ps(x0);
+                        __m512 b = cmul(_mm512_loadu_ps(x1), w2k);
+                        __m512 c = cmul(_mm512_loadu_ps(x2), w1k);
+                        __m512 d = cmul(_mm512_loadu_ps(x3), w3k);
+                        __m512 t0 = _mm512_add_ps(a, b);
+                        __m512 t1 = _mm512_sub_ps(a, b);
+                        __m512 t2 = _mm512_add_ps(c, d);
+                        __m512 jt3 = mul_j(_mm512_sub_ps(c, d), sign);
+                        _mm512_storeu_ps(x0, _mm512_add_ps(t0, t2));
+                        _mm512_storeu_ps(x1, _mm512_add_ps(t1, jt3));
+                        _mm512_storeu_ps(x2, _mm512_sub_ps(t0, t2));
+                        _mm512_storeu_ps(x3, _mm512_sub_ps(t1, jt3));
+                    }
+                }
+            }
+        }
+    }
+#endif
+}
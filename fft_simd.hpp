@@ -0,0 +1,62 @@
+#ifndef FFT_SIMD_HPP
+#define FFT_SIMD_HPP
+
+#include <complex>
+#include <cstddef>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define RSP_FFT_SIMD_X86 1
+#else
+#define RSP_FFT_SIMD_X86 0
+#endif
+
+namespace fftProcessing {
+    // Vector instruction sets the FFT kernels can use, in increasing order
+    enum class SimdLevel {
+        Scalar,
+        AVX2,   // AVX2 + FMA, 2 complex doubles per register
+        AVX512  // AVX-512F, 4 complex doubles per register
+    };
+
+    // Best level supported by the CPU and OS (cpuid/xgetbv), detected once
+    SimdLevel detect_simd_level();
+
+    // Level used by FftPlan; defaults to detect_simd_level(). Requests above the
+    // detected level are clamped to it.
+    void set_simd_level(SimdLevel level);
+    SimdLevel get_simd_level();
+    const char* simd_level_name(SimdLevel level);
+
+#if RSP_FFT_SIMD_X86
+    // Butterfly stages on interleaved complex<double> data, used by FftPlan. Each call
+    // applies the stage to 'count' rows of N elements, loading every twiddle once.
+    // Only call them when get_simd_level() reports the matching level. The float
+    // overloads hold twice as many values per register, so their minimum block sizes
+    // double.
+    namespace simd {
+        // Radix-2 stage: blocks of 2*half elements, twiddles w[0..half); half >= 2 (AVX2) or >= 4 (AVX-512)
+        void radix2_stage_avx2(std::complex<double>* const* rows, size_t count, size_t N, size_t half,
+            const std::complex<double>* w);
+        void radix2_stage_avx512(std::complex<double>* const* rows, size_t count, size_t N, size_t half,
+            const std::complex<double>* w);
+
+        // Radix-4 stage: blocks of 4*m elements, twiddle tables w1/w2/w3[0..m); m >= 2 (AVX2) or >= 4 (AVX-512)
+        void radix4_stage_avx2(std::complex<double>* const* rows, size_t count, size_t N, size_t m,
+            const std::complex<double>* w1, const std::complex<double>* w2, const std::complex<double>* w3, bool inverse);
+        void radix4_stage_avx512(std::complex<double>* const* rows, size_t count, size_t N, size_t m,
+            const std::complex<double>* w1, const std::complex<double>* w2, const std::complex<double>* w3, bool inverse);
+
+        // Single-precision variants: half/m >= 4 (AVX2) or >= 8 (AVX-512)
+        void radix2_stage_avx2(std::complex<float>* const* rows, size_t count, size_t N, size_t half,
+            const std::complex<float>* w);
+        void radix2_stage_avx512(std::complex<float>* const* rows, size_t count, size_t N, size_t half,
+            const std::complex<float>* w);
+        void radix4_stage_avx2(std::complex<float>* const* rows, size_t count, size_t N, size_t m,
+            const std::complex<float>* w1, const std::complex<float>* w2, const std::complex<float>* w3, bool inverse);
+        void radix4_stage_avx512(std::complex<float>* const* rows, size_t count, size_t N, size_t m,
+            const std::complex<float>* w1, const std::complex<float>* w2, const std::complex<float>* w3, bool inverse);
+    }
+#endif
+}
+
+#endif // FFT_SIMD_HPP
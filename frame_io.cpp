@@ -0,0 +1,477 @@
+#include "frame_io.hpp"
+#include <cstring>
+#include <cmath>
+#include <charconv>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <vector>
+#include <algorithm>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace FrameIO {
+    static_assert(sizeof(FrameFileHeader) == 48, "FrameFileHeader layout must stay fixed");
+    static_assert(sizeof(FrameTableEntry) == 16, "FrameTableEntry layout must stay fixed");
+    static_assert(FRAME_PAYLOAD_ALIGNMENT % alignof(FrameTableEntry) == 0, "Padded frame tables must be aligned");
+
+    size_t sample_size_bytes(SampleFormat format) {
+        switch (format) {
+        case SampleFormat::Int16: return sizeof(int16_t);
+        case SampleFormat::Float64: return sizeof(double);
+        }
+        return 0;
+    }
+
+    FrameFile::~FrameFile() {
+        close();
+    }
+
+    bool FrameFile::open(const std::string& path) {
+        close();
+#ifdef _WIN32
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+            CloseHandle(file);
+            return false;
+        }
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping == nullptr) {
+            CloseHandle(file);
+            return false;
+        }
+        void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (view == nullptr) {
+            CloseHandle(mapping);
+            CloseHandle(file);
+            return false;
+        }
+        file_handle_ = file;
+        mapping_handle_ = mapping;
+        data_ = static_cast<const unsigned char*>(view);
+        size_ = static_cast<size_t>(fileSize.QuadPart);
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0) {
+            ::close(fd);
+            return false;
+        }
+        void* view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd); // The mapping keeps its own reference to the file
+        if (view == MAP_FAILED) {
+            return false;
+        }
+        data_ = static_cast<const unsigned char*>(view);
+        size_ = static_cast<size_t>(st.st_size);
+#endif
+
+        // Validate header and frame table
+        bool valid = size_ >= sizeof(FrameFileHeader);
+        if (valid) {
+            std::memcpy(&header_, data_, sizeof(FrameFileHeader));
+            size_t sampleBytes = sample_size_bytes(static_cast<SampleFormat>(header_.sample_format));
+            uint64_t expectedFrameBytes = static_cast<uint64_t>(header_.num_receivers) *
+                header_.num_chirps * header_.num_samples * sampleBytes;
+            uint64_t tableBytes = static_cast<uint64_t>(header_.num_frames) * sizeof(FrameTableEntry);
+            valid = std::memcmp(header_.magic, FRAME_FILE_MAGIC, sizeof(FRAME_FILE_MAGIC)) == 0 &&
+                header_.version == FRAME_FILE_VERSION &&
+                sampleBytes != 0 &&
+                header_.frame_bytes == expectedFrameBytes &&
+                header_.frame_table_offset <= size_ &&
+                header_.frame_table_offset % alignof(FrameTableEntry) == 0 &&
+                tableBytes <= size_ - header_.frame_table_offset;
+        }
+        if (valid) {
+            table_ = reinterpret_cast<const FrameTableEntry*>(data_ + header_.frame_table_offset);
+            for (uint32_t i = 0; i < header_.num_frames && valid; ++i) {
+                valid = table_[i].offset <= size_ && header_.frame_bytes <= size_ - table_[i].offset;
+            }
+        }
+        if (!valid) {
+            std::cerr << "Error: " << path << " is not a valid radar frame file" << std::endl;
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void FrameFile::close() {
+        if (data_ != nullptr) {
+#ifdef _WIN32
+            UnmapViewOfFile(data_);
+            CloseHandle(static_cast<HANDLE>(mapping_handle_));
+            CloseHandle(static_cast<HANDLE>(file_handle_));
+            mapping_handle_ = nullptr;
+            file_handle_ = nullptr;
+#else
+            munmap(const_cast<unsigned char*>(data_), size_);
+#endif
+        }
+        data_ = nullptr;
+        size_ = 0;
+        header_ = {};
+        table_ = nullptr;
+    }
+
+    const void* FrameFile::frame_payload(int frameIndex) const {
+        if (!is_open() || header_.num_frames == 0) {
+            return nullptr;
+        }
+        // Captures are normally numbered 0..N-1, so the table slot is found directly;
+        // otherwise fall back to a binary search over the (sorted) frame numbers
+        const FrameTableEntry* entry = nullptr;
+        if (frameIndex >= 0 && static_cast<uint32_t>(frameIndex) < header_.num_frames &&
+            table_[frameIndex].frame_number == frameIndex) {
+            entry = &table_[frameIndex];
+        }
+        else {
+            const FrameTableEntry* end = table_ + header_.num_frames;
+            const FrameTableEntry* it = std::lower_bound(table_, end, static_cast<int64_t>(frameIndex),
+                [](const FrameTableEntry& e, int64_t value) { return e.frame_number < value; });
+            if (it != end && it->frame_number == frameIndex) {
+                entry = it;
+            }
+        }
+        return entry != nullptr ? data_ + entry->offset : nullptr;
+    }
+
+    namespace {
+        // Round a sample to the nearest int16 ADC count, clamping out-of-range values
+        int16_t to_adc_count(double value, size_t& clampedCount) {
+            double rounded = std::round(value);
+            if (rounded > std::numeric_limits<int16_t>::max() || rounded < std::numeric_limits<int16_t>::min()) {
+                clampedCount++;
+                rounded = std::min<double>(std::max<double>(rounded, std::numeric_limits<int16_t>::min()),
+                    std::numeric_limits<int16_t>::max());
+            }
+            return static_cast<int16_t>(rounded);
+        }
+
+        void warn_clamped(size_t clampedCount) {
+            if (clampedCount > 0) {
+                std::cerr << "Warning: " << clampedCount << " samples exceeded the int16 range and were clamped" << std::endl;
+            }
+        }
+    }
+
+    bool FrameFile::load_frame(int frameIndex, RadarData::Frame& frame, RadarData::CubeLayout layout) const {
+        const void* payload = frame_payload(frameIndex);
+        if (payload == nullptr) {
+            return false;
+        }
+        int num_receivers = this->num_receivers();
+        int num_chirps = this->num_chirps();
+        int num_samples = this->num_samples();
+
+        frame.resize(num_receivers, num_chirps, num_samples, layout);
+
+        if (sample_format() == SampleFormat::Int16) {
+            const int16_t* samples = static_cast<const int16_t*>(payload);
+            for (int r = 0; r < num_receivers; r++) {
+                for (int c = 0; c < num_chirps; c++) {
+                    for (int s = 0; s < num_samples; s++) {
+                        frame(r, c, s) = RadarData::Complex(*samples++, 0);
+                    }
+                }
+            }
+        }
+        else {
+            const unsigned char* bytes = static_cast<const unsigned char*>(payload);
+            for (int r = 0; r < num_receivers; r++) {
+                for (int c = 0; c < num_chirps; c++) {
+                    for (int s = 0; s < num_samples; s++) {
+                        double value;
+                        std::memcpy(&value, bytes, sizeof(double));
+                        bytes += sizeof(double);
+                        frame(r, c, s) = RadarData::Complex(value, 0);
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    bool FrameFile::load_raw_frame(int frameIndex, RadarData::RawFrame& frame) const {
+        const void* payload = frame_payload(frameIndex);
+        if (payload == nullptr) {
+            return false;
+        }
+        frame.resize(num_receivers(), num_chirps(), num_samples());
+
+        if (sample_format() == SampleFormat::Int16) {
+            // Payload is already in the cube's (r, c, s) order
+            std::memcpy(frame.data(), payload, frame.size() * sizeof(int16_t));
+        }
+        else {
+            const unsigned char* bytes = static_cast<const unsigned char*>(payload);
+            int16_t* samples = frame.data();
+            size_t clampedCount = 0;
+            for (size_t i = 0; i < frame.size(); ++i) {
+                double value;
+                std::memcpy(&value, bytes, sizeof(double));
+                bytes += sizeof(double);
+                samples[i] = to_adc_count(value, clampedCount);
+            }
+            warn_clamped(clampedCount);
+        }
+        return true;
+    }
+
+    namespace {
+        // Zero-pad the output to the next FRAME_PAYLOAD_ALIGNMENT boundary and return that offset
+        uint64_t pad_to_alignment(std::ofstream& out) {
+            uint64_t position = static_cast<uint64_t>(out.tellp());
+            uint64_t padding = (FRAME_PAYLOAD_ALIGNMENT - position % FRAME_PAYLOAD_ALIGNMENT) % FRAME_PAYLOAD_ALIGNMENT;
+            static const char zeros[FRAME_PAYLOAD_ALIGNMENT] = {};
+            out.write(zeros, static_cast<std::streamsize>(padding));
+            return position + padding;
+        }
+
+        // Write one dense frame to the output, padding so the payload starts aligned
+        bool write_frame(std::ofstream& out, const std::vector<double>& values, SampleFormat format,
+            int64_t frameNumber, std::vector<FrameTableEntry>& table, size_t& clampedCount) {
+            table.push_back({ frameNumber, pad_to_alignment(out) });
+
+            if (format == SampleFormat::Int16) {
+                std::vector<int16_t> samples(values.size());
+                for (size_t i = 0; i < values.size(); ++i) {
+                    samples[i] = to_adc_count(values[i], clampedCount);
+                }
+                out.write(reinterpret_cast<const char*>(samples.data()),
+                    static_cast<std::streamsize>(samples.size() * sizeof(int16_t)));
+            }
+            else {
+                out.write(reinterpret_cast<const char*>(values.data()),
+                    static_cast<std::streamsize>(values.size() * sizeof(double)));
+            }
+            return static_cast<bool>(out);
+        }
+    }
+
+    namespace {
+        constexpr size_t READ_BUFFER_BYTES = 1 << 20;
+
+        const char* skip_blanks(const char* p, const char* end) {
+            while (p < end && (*p == ' ' || *p == '\t')) {
+                ++p;
+            }
+            return p;
+        }
+
+        // Parse one field followed by an optional ',' separator
+        template <typename T>
+        bool parse_field(const char*& p, const char* end, T& value) {
+            p = skip_blanks(p, end);
+            auto result = std::from_chars(p, end, value);
+            if (result.ec != std::errc()) {
+                return false;
+            }
+            p = skip_blanks(result.ptr, end);
+            if (p < end && *p == ',') {
+                ++p;
+            }
+            return true;
+        }
+    }
+
+    FrameReader::FrameReader(int num_receivers, int num_chirps, int num_samples)
+        : num_receivers_(num_receivers), num_chirps_(num_chirps), num_samples_(num_samples) {
+    }
+
+    bool FrameReader::open(const std::string& path) {
+        file_.close();
+        file_.clear();
+        file_.open(path, std::ios::binary);
+        buffer_.resize(READ_BUFFER_BYTES);
+        pos_ = 0;
+        end_ = 0;
+        eof_ = false;
+        has_pending_ = false;
+        return file_.is_open();
+    }
+
+    bool FrameReader::next_line(const char*& begin, const char*& end) {
+        while (true) {
+            const char* data = buffer_.data();
+            const void* newline = std::memchr(data + pos_, '\n', end_ - pos_);
+            if (newline != nullptr) {
+                begin = data + pos_;
+                end = static_cast<const char*>(newline);
+                pos_ = static_cast<size_t>(end - data) + 1;
+                return true;
+            }
+            if (eof_) {
+                if (pos_ == end_) {
+                    return false;
+                }
+                // Last line without a trailing newline
+                begin = data + pos_;
+                end = data + end_;
+                pos_ = end_;
+                return true;
+            }
+            // Move the partial line to the front and refill the rest of the buffer
+            size_t remaining = end_ - pos_;
+            std::memmove(buffer_.data(), buffer_.data() + pos_, remaining);
+            if (remaining == buffer_.size()) {
+                buffer_.resize(buffer_.size() * 2); // Line longer than the buffer
+            }
+            file_.read(buffer_.data() + remaining, static_cast<std::streamsize>(buffer_.size() - remaining));
+            pos_ = 0;
+            end_ = remaining + static_cast<size_t>(file_.gcount());
+            eof_ = !file_;
+        }
+    }
+
+    bool FrameReader::next_record(Record& record) {
+        const char* begin;
+        const char* end;
+        while (next_line(begin, end)) {
+            if (end > begin && end[-1] == '\r') {
+                --end;
+            }
+            const char* p = begin;
+            if (parse_field(p, end, record.frame_number) &&
+                parse_field(p, end, record.receiver) &&
+                parse_field(p, end, record.chirp) &&
+                parse_field(p, end, record.sample) &&
+                parse_field(p, end, record.value)) {
+                return true;
+            }
+            // Header or malformed line
+        }
+        return false;
+    }
+
+    template <typename Store>
+    bool FrameReader::read_frame(Store&& store, int& frameNumber) {
+        Record record;
+        if (has_pending_) {
+            record = pending_;
+            has_pending_ = false;
+        }
+        else if (!is_open() || !next_record(record)) {
+            return false;
+        }
+
+        frameNumber = record.frame_number;
+        do {
+            if (record.frame_number != frameNumber) {
+                // First line of the following frame; keep it for the next call
+                pending_ = record;
+                has_pending_ = true;
+                break;
+            }
+            if (record.receiver >= 0 && record.receiver < num_receivers_ &&
+                record.chirp >= 0 && record.chirp < num_chirps_ &&
+                record.sample >= 0 && record.sample < num_samples_) {
+                store(record.receiver, record.chirp, record.sample, record.value);
+            }
+        } while (next_record(record));
+        return true;
+    }
+
+    bool FrameReader::next_frame(RadarData::Frame& frame, int& frameNumber, RadarData::CubeLayout layout) {
+        frame.resize(num_receivers_, num_chirps_, num_samples_, layout);
+        return read_frame([&frame](int r, int c, int s, double value) {
+            frame(r, c, s) = RadarData::Complex(value, 0); // Store as complex with imaginary part 0
+        }, frameNumber);
+    }
+
+    bool FrameReader::next_raw_frame(RadarData::RawFrame& frame, int& frameNumber) {
+        frame.resize(num_receivers_, num_chirps_, num_samples_);
+        size_t clampedCount = 0;
+        bool found = read_frame([&frame, &clampedCount](int r, int c, int s, double value) {
+            frame(r, c, s) = to_adc_count(value, clampedCount);
+        }, frameNumber);
+        warn_clamped(clampedCount);
+        return found;
+    }
+
+    bool FrameReader::next_frame_values(std::vector<double>& values, int& frameNumber) {
+        const size_t chirpStride = static_cast<size_t>(num_samples_);
+        const size_t receiverStride = static_cast<size_t>(num_chirps_) * chirpStride;
+        values.assign(static_cast<size_t>(num_receivers_) * receiverStride, 0.0);
+        return read_frame([&values, chirpStride, receiverStride](int r, int c, int s, double value) {
+            values[r * receiverStride + c * chirpStride + s] = value;
+        }, frameNumber);
+    }
+
+    bool convert_csv_to_binary(const std::string& csvPath, const std::string& binPath,
+        int num_receivers, int num_chirps, int num_samples, SampleFormat format) {
+        FrameReader reader(num_receivers, num_chirps, num_samples);
+        if (!reader.open(csvPath)) {
+            std::cerr << "Error: Could not open " << csvPath << std::endl;
+            return false;
+        }
+        std::ofstream out(binPath, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            std::cerr << "Error: Could not create " << binPath << std::endl;
+            return false;
+        }
+
+        FrameFileHeader header = {};
+        std::memcpy(header.magic, FRAME_FILE_MAGIC, sizeof(FRAME_FILE_MAGIC));
+        header.version = FRAME_FILE_VERSION;
+        header.sample_format = static_cast<uint32_t>(format);
+        header.num_receivers = static_cast<uint32_t>(num_receivers);
+        header.num_chirps = static_cast<uint32_t>(num_chirps);
+        header.num_samples = static_cast<uint32_t>(num_samples);
+        header.frame_bytes = static_cast<uint64_t>(num_receivers) * num_chirps * num_samples * sample_size_bytes(format);
+        // Placeholder, rewritten once the frame count and table offset are known
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        std::vector<double> values;
+        std::vector<FrameTableEntry> table;
+        size_t clampedCount = 0;
+        int frameNumber;
+        while (reader.next_frame_values(values, frameNumber)) {
+            if (!table.empty() && frameNumber <= table.back().frame_number) {
+                std::cerr << "Error: Frames in " << csvPath << " are not in ascending order" << std::endl;
+                return false;
+            }
+            if (!write_frame(out, values, format, frameNumber, table, clampedCount)) {
+                std::cerr << "Error: Failed writing " << binPath << std::endl;
+                return false;
+            }
+        }
+
+        header.num_frames = static_cast<uint32_t>(table.size());
+        // Aligned like the payloads, as FrameFile::open requires of the table
+        header.frame_table_offset = pad_to_alignment(out);
+        out.write(reinterpret_cast<const char*>(table.data()),
+            static_cast<std::streamsize>(table.size() * sizeof(FrameTableEntry)));
+        out.seekp(0);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        if (!out) {
+            std::cerr << "Error: Failed writing " << binPath << std::endl;
+            return false;
+        }
+
+        warn_clamped(clampedCount);
+        std::cout << "Converted " << table.size() << " frames from " << csvPath << " to " << binPath << std::endl;
+        return true;
+    }
+}
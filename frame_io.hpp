@@ -0,0 +1,141 @@
+#ifndef FRAME_IO_HPP
+#define FRAME_IO_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <fstream>
+#include <vector>
+#include "datatypes.hpp"
+
+namespace FrameIO {
+    // Binary capture layout (little endian):
+    //   FrameFileHeader
+    //   frame payloads, each num_receivers * num_chirps * num_samples samples in
+    //   receiver-major (r, c, s) order, starting on a 64-byte boundary
+    //   FrameTableEntry[num_frames] at frame_table_offset, also on a 64-byte boundary
+    constexpr char FRAME_FILE_MAGIC[8] = { 'R', 'S', 'P', 'F', 'R', 'A', 'M', 'E' };
+    constexpr uint32_t FRAME_FILE_VERSION = 1;
+    constexpr uint64_t FRAME_PAYLOAD_ALIGNMENT = 64;
+
+    // Storage type of one ADC sample in the payload
+    enum class SampleFormat : uint32_t {
+        Int16 = 1,   // Raw 16-bit ADC counts (RadarConfig::SAMPLE_SIZE_BYTES)
+        Float64 = 2  // Already scaled values
+    };
+
+    struct FrameFileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t sample_format;      // SampleFormat
+        uint32_t num_receivers;
+        uint32_t num_chirps;
+        uint32_t num_samples;
+        uint32_t num_frames;
+        uint64_t frame_bytes;        // Payload size of one frame in bytes
+        uint64_t frame_table_offset; // File offset of the FrameTableEntry array
+    };
+
+    struct FrameTableEntry {
+        int64_t frame_number;        // Frame index as it appeared in the capture
+        uint64_t offset;             // File offset of the frame payload
+    };
+
+    size_t sample_size_bytes(SampleFormat format);
+
+    // Read-only memory-mapped view of a binary capture. Frame N is located through
+    // the frame table, so loading it does not depend on how many frames precede it.
+    class FrameFile {
+    public:
+        FrameFile() = default;
+        ~FrameFile();
+        FrameFile(const FrameFile&) = delete;
+        FrameFile& operator=(const FrameFile&) = delete;
+
+        // Map the file and validate its header; returns false on failure
+        bool open(const std::string& path);
+        void close();
+        bool is_open() const { return data_ != nullptr; }
+
+        int num_receivers() const { return static_cast<int>(header_.num_receivers); }
+        int num_chirps() const { return static_cast<int>(header_.num_chirps); }
+        int num_samples() const { return static_cast<int>(header_.num_samples); }
+        int num_frames() const { return static_cast<int>(header_.num_frames); }
+        SampleFormat sample_format() const { return static_cast<SampleFormat>(header_.sample_format); }
+
+        // Pointer to the payload of the requested frame, or nullptr if it is not present
+        const void* frame_payload(int frameIndex) const;
+
+        // Copy the requested frame into 'frame' with the given layout; returns false if
+        // the frame is not present
+        bool load_frame(int frameIndex, RadarData::Frame& frame,
+            RadarData::CubeLayout layout = RadarData::CubeLayout::ReceiverChirpSample) const;
+        // Copy the requested frame as raw int16 samples (Float64 captures are rounded
+        // and clamped); returns false if the frame is not present
+        bool load_raw_frame(int frameIndex, RadarData::RawFrame& frame) const;
+
+    private:
+        const unsigned char* data_ = nullptr;
+        size_t size_ = 0;
+        FrameFileHeader header_ = {};
+        const FrameTableEntry* table_ = nullptr;
+#ifdef _WIN32
+        void* file_handle_ = nullptr;
+        void* mapping_handle_ = nullptr;
+#endif
+    };
+
+    // Single-pass reader for radar_indexed.csv style captures. The file stays open
+    // and frames are yielded in the order they appear, so each line is parsed once.
+    class FrameReader {
+    public:
+        FrameReader(int num_receivers, int num_chirps, int num_samples);
+
+        bool open(const std::string& path);
+        bool is_open() const { return file_.is_open(); }
+
+        // Fill 'frame' (with the given layout) with the next frame in the file and report
+        // its frame number. Cells missing from the capture are zero. Returns false at end of file.
+        bool next_frame(RadarData::Frame& frame, int& frameNumber,
+            RadarData::CubeLayout layout = RadarData::CubeLayout::ReceiverChirpSample);
+
+        // Same as next_frame, but keeps raw int16 samples (rounded and clamped)
+        bool next_raw_frame(RadarData::RawFrame& frame, int& frameNumber);
+
+        // Same as next_frame, but delivers the samples densely in (r, c, s) order
+        bool next_frame_values(std::vector<double>& values, int& frameNumber);
+
+    private:
+        struct Record {
+            int frame_number;
+            int receiver;
+            int chirp;
+            int sample;
+            double value;
+        };
+
+        bool next_line(const char*& begin, const char*& end);
+        bool next_record(Record& record);
+        template <typename Store>
+        bool read_frame(Store&& store, int& frameNumber);
+
+        int num_receivers_;
+        int num_chirps_;
+        int num_samples_;
+        std::ifstream file_;
+        std::vector<char> buffer_;
+        size_t pos_ = 0;
+        size_t end_ = 0;
+        bool eof_ = false;
+        bool has_pending_ = false;
+        Record pending_ = {};
+    };
+
+    // One-shot conversion of a radar_indexed.csv style capture
+    // (frame_number, receiver, chirp, sample, value per line) into the binary format
+    bool convert_csv_to_binary(const std::string& csvPath, const std::string& binPath,
+        int num_receivers, int num_chirps, int num_samples,
+        SampleFormat format = SampleFormat::Int16);
+}
+
+#endif // FRAME_IO_HPP
@@ -0,0 +1,286 @@
+#include "hermitian_eigen.hpp"
+#include "config.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+namespace DOAProcessing {
+    namespace {
+        constexpr int MAX_JACOBI_SWEEPS = 30;
+
+        // a * b without the inf/nan recovery of the library operator, which is not inlined
+        template <typename T>
+        inline std::complex<T> mul(const std::complex<T>& a, const std::complex<T>& b) {
+            return std::complex<T>(a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real());
+        }
+
+        // Bilinear cross product: orthogonal to a and b under sum(x[i] * y[i]), so for rows a and b
+        // of a singular matrix it spans the null space
+        inline void cross(const std::complex<double>* a, const std::complex<double>* b, std::complex<double>* out) {
+            out[0] = mul(a[1], b[2]) - mul(a[2], b[1]);
+            out[1] = mul(a[2], b[0]) - mul(a[0], b[2]);
+            out[2] = mul(a[0], b[1]) - mul(a[1], b[0]);
+        }
+
+        inline double squared_norm(const std::complex<double>* v) {
+            return std::norm(v[0]) + std::norm(v[1]) + std::norm(v[2]);
+        }
+
+        inline void normalize(std::complex<double>* v) {
+            const double length = std::sqrt(squared_norm(v));
+            for (int i = 0; i < 3; i++) {
+                v[i] /= length;
+            }
+        }
+
+        // Order the eigenpairs by descending eigenvalue
+        template <typename T>
+        void sort_descending(SmallEigen<T>& eigen) {
+            for (int i = 1; i < eigen.n; i++) {
+                for (int j = i; j > 0 && eigen.values[j] > eigen.values[j - 1]; j--) {
+                    std::swap(eigen.values[j], eigen.values[j - 1]);
+                    std::swap_ranges(eigen.vectors[j], eigen.vectors[j] + eigen.n, eigen.vectors[j - 1]);
+                }
+            }
+        }
+    }
+
+    template <typename T>
+    bool eigen_hermitian_3x3(const SmallMatrix<T>& matrix, SmallEigen<T>& eigen) {
+        if (matrix.n != 3) {
+            std::cerr << "eigen_hermitian_3x3 called on a " << matrix.n << "x" << matrix.n << " matrix" << std::endl;
+            return false;
+        }
+        eigen.n = 3;
+
+        // Work in double whatever T is: the cubic loses accuracy quickly in float
+        std::complex<double> a[3][3];
+        for (int i = 0; i < 3; i++) {
+            a[i][i] = std::real(matrix.a[i][i]);
+            for (int j = i + 1; j < 3; j++) {
+                a[i][j] = matrix.a[i][j];
+                a[j][i] = std::conj(a[i][j]);
+            }
+        }
+
+        // Eigenvalues of A = q*I + p*B from det(B) / 2 = cos(3 * phi)
+        const double q = (a[0][0].real() + a[1][1].real() + a[2][2].real()) / 3.0;
+        const double p1 = std::norm(a[0][1]) + std::norm(a[0][2]) + std::norm(a[1][2]);
+        const double b00 = a[0][0].real() - q;
+        const double b11 = a[1][1].real() - q;
+        const double b22 = a[2][2].real() - q;
+        const double p2 = b00 * b00 + b11 * b11 + b22 * b22 + 2.0 * p1;
+        const double magnitude = std::abs(q) + std::sqrt(p2);
+        if (p2 <= std::numeric_limits<double>::epsilon() * std::numeric_limits<double>::epsilon() * magnitude * magnitude) {
+            // A multiple of the identity: any basis will do
+            for (int k = 0; k < 3; k++) {
+                eigen.values[k] = static_cast<T>(q);
+                for (int i = 0; i < 3; i++) {
+                    eigen.vectors[k][i] = std::complex<T>(k == i ? T(1) : T(0), T(0));
+                }
+            }
+            return true;
+        }
+        const double p = std::sqrt(p2 / 6.0);
+        const double det = b00 * b11 * b22 + 2.0 * std::real(mul(mul(a[0][1], a[1][2]), a[2][0]))
+            - b00 * std::norm(a[1][2]) - b11 * std::norm(a[0][2]) - b22 * std::norm(a[0][1]);
+        const double r = std::min(std::max(det / (2.0 * p * p * p), -1.0), 1.0);
+        const double phi = std::acos(r) / 3.0;
+        const double largest = q + 2.0 * p * std::cos(phi);
+        const double smallest = q + 2.0 * p * std::cos(phi + 2.0 * RadarConfig::PI / 3.0);
+        const double middle = 3.0 * q - largest - smallest;
+
+        // Eigenvector of the eigenvalue furthest from the other two: the best-conditioned cross
+        // product of two rows of A - lambda*I
+        const bool isolatedLargest = largest - middle >= middle - smallest;
+        const double isolated = isolatedLargest ? largest : smallest;
+        std::complex<double> rows[3][3];
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < 3; j++) {
+                rows[i][j] = a[i][j] - (i == j ? isolated : 0.0);
+            }
+        }
+        std::complex<double> v[3];
+        std::complex<double> candidate[3];
+        cross(rows[0], rows[1], v);
+        double best = squared_norm(v);
+        const int pairs[2][2] = { { 0, 2 }, { 1, 2 } };
+        for (const auto& pair : pairs) {
+            cross(rows[pair[0]], rows[pair[1]], candidate);
+            double length = squared_norm(candidate);
+            if (length > best) {
+                best = length;
+                std::copy(candidate, candidate + 3, v);
+            }
+        }
+        normalize(v);
+
+        // Orthonormal basis u, w of the complement of v
+        int axis = 0;
+        for (int i = 1; i < 3; i++) {
+            if (std::norm(v[i]) < std::norm(v[axis])) {
+                axis = i;
+            }
+        }
+        std::complex<double> u[3];
+        for (int i = 0; i < 3; i++) {
+            u[i] = (i == axis ? 1.0 : 0.0) - mul(v[i], std::conj(v[axis]));
+        }
+        normalize(u);
+        std::complex<double> w[3];
+        cross(v, u, w);
+        for (int i = 0; i < 3; i++) {
+            w[i] = std::conj(w[i]);
+        }
+        normalize(w);
+
+        // A restricted to span(u, w) as a 2 x 2 Hermitian matrix [b00 b01; conj(b01) b11]
+        std::complex<double> au[3], aw[3];
+        for (int i = 0; i < 3; i++) {
+            au[i] = mul(a[i][0], u[0]) + mul(a[i][1], u[1]) + mul(a[i][2], u[2]);
+            aw[i] = mul(a[i][0], w[0]) + mul(a[i][1], w[1]) + mul(a[i][2], w[2]);
+        }
+        double c00 = 0.0, c11 = 0.0;
+        std::complex<double> c01 = 0.0;
+        for (int i = 0; i < 3; i++) {
+            c00 += std::real(mul(std::conj(u[i]), au[i]));
+            c11 += std::real(mul(std::conj(w[i]), aw[i]));
+            c01 += mul(std::conj(u[i]), aw[i]);
+        }
+        const double half = (c00 - c11) / 2.0;
+        const double radius = std::sqrt(half * half + std::norm(c01));
+        const double mean = (c00 + c11) / 2.0;
+        std::complex<double> x0, x1;
+        if (std::norm(c01) == 0.0) {
+            x0 = half >= 0.0 ? 1.0 : 0.0;
+            x1 = half >= 0.0 ? 0.0 : 1.0;
+        }
+        else if (half >= 0.0) {
+            x0 = half + radius;
+            x1 = std::conj(c01);
+        }
+        else {
+            x0 = c01;
+            x1 = radius - half;
+        }
+        const double length = std::sqrt(std::norm(x0) + std::norm(x1));
+        x0 /= length;
+        x1 /= length;
+
+        // Assemble the three pairs, isolated one first or last
+        const int first = isolatedLargest ? 0 : 2;
+        const int upper = isolatedLargest ? 1 : 0;
+        eigen.values[first] = static_cast<T>(isolated);
+        eigen.values[upper] = static_cast<T>(mean + radius);
+        eigen.values[upper + 1] = static_cast<T>(mean - radius);
+        for (int i = 0; i < 3; i++) {
+            eigen.vectors[first][i] = std::complex<T>(v[i]);
+            eigen.vectors[upper][i] = std::complex<T>(mul(x0, u[i]) + mul(x1, w[i]));
+            eigen.vectors[upper + 1][i] = std::complex<T>(mul(-std::conj(x1), u[i]) + mul(std::conj(x0), w[i]));
+        }
+        sort_descending(eigen);
+        return true;
+    }
+
+    template <typename T>
+    bool eigen_hermitian_jacobi(const SmallMatrix<T>& matrix, SmallEigen<T>& eigen) {
+        const int n = matrix.n;
+        if (n < 1 || n > MAX_EIGEN_SIZE) {
+            std::cerr << "Jacobi eigensolver supports 1 to " << MAX_EIGEN_SIZE << " rows, got " << n << std::endl;
+            return false;
+        }
+        eigen.n = n;
+
+        // Hermitian working copy from the upper triangle; eigenvectors accumulate in v's columns
+        std::complex<T> a[MAX_EIGEN_SIZE][MAX_EIGEN_SIZE];
+        std::complex<T> v[MAX_EIGEN_SIZE][MAX_EIGEN_SIZE];
+        T total = 0;
+        for (int i = 0; i < n; i++) {
+            a[i][i] = std::real(matrix.a[i][i]);
+            total += std::norm(a[i][i]);
+            for (int j = i + 1; j < n; j++) {
+                a[i][j] = matrix.a[i][j];
+                a[j][i] = std::conj(a[i][j]);
+                total += 2 * std::norm(a[i][j]);
+            }
+            for (int j = 0; j < n; j++) {
+                v[i][j] = std::complex<T>(i == j ? T(1) : T(0), T(0));
+            }
+        }
+        const T tolerance = std::numeric_limits<T>::epsilon() * std::numeric_limits<T>::epsilon() * total;
+
+        for (int sweep = 0; sweep < MAX_JACOBI_SWEEPS; sweep++) {
+            T off = 0;
+            for (int p = 0; p < n; p++) {
+                for (int q = p + 1; q < n; q++) {
+                    off += std::norm(a[p][q]);
+                }
+            }
+            if (off <= tolerance) {
+                break;
+            }
+
+            for (int p = 0; p < n; p++) {
+                for (int q = p + 1; q < n; q++) {
+                    const T magnitude = std::sqrt(std::norm(a[p][q]));
+                    if (magnitude <= std::numeric_limits<T>::min()) {
+                        continue;
+                    }
+
+                    // Real Jacobi rotation on the phase-aligned pair: J = [c, s*e; -s*conj(e), c]
+                    const std::complex<T> e = a[p][q] / magnitude;
+                    const T theta = (a[q][q].real() - a[p][p].real()) / (2 * magnitude);
+                    const T t = (theta >= 0 ? T(1) : T(-1)) / (std::abs(theta) + std::sqrt(theta * theta + 1));
+                    const T c = 1 / std::sqrt(t * t + 1);
+                    const T s = t * c;
+                    const std::complex<T> se = s * e;
+                    const std::complex<T> sec = s * std::conj(e);
+
+                    for (int k = 0; k < n; k++) {
+                        const std::complex<T> akp = a[k][p];
+                        const std::complex<T> akq = a[k][q];
+                        a[k][p] = c * akp - mul(sec, akq);
+                        a[k][q] = mul(se, akp) + c * akq;
+                    }
+                    for (int k = 0; k < n; k++) {
+                        const std::complex<T> apk = a[p][k];
+                        const std::complex<T> aqk = a[q][k];
+                        a[p][k] = c * apk - mul(se, aqk);
+                        a[q][k] = mul(sec, apk) + c * aqk;
+                    }
+                    a[p][q] = a[q][p] = 0;
+                    a[p][p] = a[p][p].real();
+                    a[q][q] = a[q][q].real();
+                    for (int k = 0; k < n; k++) {
+                        const std::complex<T> vkp = v[k][p];
+                        const std::complex<T> vkq = v[k][q];
+                        v[k][p] = c * vkp - mul(sec, vkq);
+                        v[k][q] = mul(se, vkp) + c * vkq;
+                    }
+                }
+            }
+        }
+
+        for (int k = 0; k < n; k++) {
+            eigen.values[k] = a[k][k].real();
+            for (int i = 0; i < n; i++) {
+                eigen.vectors[k][i] = v[i][k];
+            }
+        }
+        sort_descending(eigen);
+        return true;
+    }
+
+    template <typename T>
+    bool eigen_hermitian(const SmallMatrix<T>& matrix, SmallEigen<T>& eigen) {
+        return matrix.n == 3 ? eigen_hermitian_3x3(matrix, eigen) : eigen_hermitian_jacobi(matrix, eigen);
+    }
+
+    template bool eigen_hermitian_3x3<float>(const SmallMatrix<float>& matrix, SmallEigen<float>& eigen);
+    template bool eigen_hermitian_3x3<double>(const SmallMatrix<double>& matrix, SmallEigen<double>& eigen);
+    template bool eigen_hermitian_jacobi<float>(const SmallMatrix<float>& matrix, SmallEigen<float>& eigen);
+    template bool eigen_hermitian_jacobi<double>(const SmallMatrix<double>& matrix, SmallEigen<double>& eigen);
+    template bool eigen_hermitian<float>(const SmallMatrix<float>& matrix, SmallEigen<float>& eigen);
+    template bool eigen_hermitian<double>(const SmallMatrix<double>& matrix, SmallEigen<double>& eigen);
+}
@@ -0,0 +1,43 @@
+#ifndef HERMITIAN_EIGEN_HPP
+#define HERMITIAN_EIGEN_HPP
+
+#include <complex>
+
+namespace DOAProcessing {
+    // Largest matrix the small eigensolvers take (virtual array elements)
+    constexpr int MAX_EIGEN_SIZE = 16;
+
+    // n x n complex matrix in fixed storage, so covariance matrices live on the stack
+    template <typename T>
+    struct SmallMatrix {
+        int n = 0;
+        std::complex<T> a[MAX_EIGEN_SIZE][MAX_EIGEN_SIZE];
+    };
+
+    // Eigenpairs of a Hermitian matrix: values in descending order, vectors[k] the unit
+    // eigenvector of values[k]
+    template <typename T>
+    struct SmallEigen {
+        int n = 0;
+        T values[MAX_EIGEN_SIZE];
+        std::complex<T> vectors[MAX_EIGEN_SIZE][MAX_EIGEN_SIZE];
+    };
+
+    // Closed-form solver for n == 3: eigenvalues from the trigonometric solution of the
+    // characteristic cubic, one eigenvector from a cross product of the rows of A - lambda*I and
+    // the other two from the 2 x 2 problem on its orthogonal complement
+    template <typename T>
+    bool eigen_hermitian_3x3(const SmallMatrix<T>& matrix, SmallEigen<T>& eigen);
+
+    // Cyclic complex Jacobi rotations for 1 <= n <= MAX_EIGEN_SIZE, sweeping until the
+    // off-diagonal part is negligible (a fixed number of sweeps at most)
+    template <typename T>
+    bool eigen_hermitian_jacobi(const SmallMatrix<T>& matrix, SmallEigen<T>& eigen);
+
+    // Dispatch: the closed form for 3 x 3, Jacobi otherwise. Only the upper triangle is read.
+    // Returns false for sizes outside [1, MAX_EIGEN_SIZE].
+    template <typename T>
+    bool eigen_hermitian(const SmallMatrix<T>& matrix, SmallEigen<T>& eigen);
+}
+
+#endif // HERMITIAN_EIGEN_HPP
@@ -1,9 +1,19 @@
 #include <iostream>
+#include <string>
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <tuple>
 #include <chrono> // Include for timing functions
+#include <random>
+#include <fstream>
+#include <cstdio> // For std::remove
 //#include "matplotlibcpp.h"
 #include "config.hpp"
 #include "datatypes.hpp"
+#include "frame_io.hpp"
 #include "fft_processing.hpp"
+#include "fft_simd.hpp"
 #include "peak_detection.hpp"
 #include "mimo_synthesis.hpp"
 #include "doa_processing.hpp"
@@ -11,72 +21,456 @@
 #include "rcs.hpp"
 #include "ego_estimation.hpp"
 #include "ghost_removal.hpp"
+#include "thread_pool.hpp"
 
 
-int main() {
+// Steps 1-4 (FFT, peak detection, MIMO synthesis, DOA) on a raw frame, with 'frame'
+// receiving the FFT output in either precision and 'magnitude' its |x|^2 map
+template <typename T>
+void process_frame(const RadarData::RawFrame& raw, RadarData::BasicRadarCube<T>& frame, const RadarConfig::Config& rconfig,
+    RadarData::BasicMagnitudeMap<T>& magnitude, RadarData::PeakList& peakList, RadarData::BasicPeakSnaps<T>& peakSnaps,
+    std::vector<std::pair<double, double>>& doaResults) {
+    //*********************STEP 1 FFT PROCESSING *******************
+    auto start = std::chrono::high_resolution_clock::now();
+    // TDM-MIMO captures are split into one virtual receiver per (tx, rx) pair first
+    thread_local RadarData::RawFrame virtualRaw;
+    const bool tdm = rconfig.num_transmitters > 1;
+    if (tdm && !MIMOSynthesis::deinterleave_tdm(raw, rconfig.num_transmitters, virtualRaw)) {
+        return;
+    }
+    fftProcessing::fftProcessPipeline(tdm ? virtualRaw : raw, frame, rconfig);
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> elapsed = end - start;
+    std::cout << "Time taken for fftProcessPipeline: " << elapsed.count() << " seconds" << std::endl;
+
+    //*********************STEP 2 PEAK DETECTION  *******************
+    start = std::chrono::high_resolution_clock::now();
+    // |x|^2 per receiver, integrated over the receivers into one map for a single CFAR pass
+    PeakDetection::compute_magnitude_map(frame, magnitude, RadarData::MagnitudeScale::Power);
+    thread_local RadarData::BasicMagnitudeMap<T> integrated;
+    PeakDetection::compute_nci(magnitude, integrated);
+    PeakDetection::cfar_peak_detection(integrated, peakList, rconfig);
+    size_t detections = peakList.size();
+    // One detection per target before MIMO synthesis and DOA
+    PeakDetection::group_peaks(integrated, peakList, rconfig.peak_grouping_radius);
+    end = std::chrono::high_resolution_clock::now();
+    elapsed = end - start;
+    std::cout << "Number of CFAR detections: " << detections << std::endl;
+    std::cout << "Number of peaks detected: " << peakList.size() << std::endl;
+    std::cout << "Time taken for peakDetection: " << elapsed.count() << " seconds" << std::endl;
+
+    //*********************STEP 3 MIMO SYNTHESIS PEAK SNAP DETECTION  *******************
+    start = std::chrono::high_resolution_clock::now();
+    // Virtual array and its Doppler phase table, rebuilt only when the frame shape changes
+    thread_local MIMOSynthesis::BasicVirtualArray<T> virtualArray;
+    thread_local DOAProcessing::BasicSteeringTable<T> steeringTable;
+    const double gridStep = DOAProcessing::music_grid_step(rconfig);
+    if (virtualArray.num_elements() != frame.num_receivers() || virtualArray.num_doppler_bins() != frame.num_chirps()
+        || steeringTable.step_deg() != gridStep) {
+        virtualArray.build(rconfig, frame.num_chirps());
+        steeringTable.build(virtualArray.positions(), rconfig.wavelength, RadarConfig::MUSIC_GRID_LIMIT_DEG, gridStep);
+    }
+    MIMOSynthesis::synthesize_peaks(peakList, frame, virtualArray, peakSnaps);
+    end = std::chrono::high_resolution_clock::now();
+    elapsed = end - start;
+    std::cout << "Time taken for MIMO synthesis: " << elapsed.count() << " seconds" << std::endl;
+
+    //*********************STEP 4 DOA PROCESSING  *******************
+    start = std::chrono::high_resolution_clock::now();
+    DOAProcessing::compute_music_doa(peakSnaps, steeringTable, doaResults, /*num_sources=*/1, rconfig);
+    end = std::chrono::high_resolution_clock::now();
+    elapsed = end - start;
+    std::cout << "Time taken for DOA processing: " << elapsed.count() << " seconds" << std::endl;
+}
+
+// Convert single-precision peak snaps for the double-precision target stages
+void widen_peak_snaps(const RadarData::BasicPeakSnaps<float>& source, RadarData::PeakSnaps& peakSnaps) {
+    peakSnaps.assign(source);
+}
+
+// Convert a small CSV whose frame size is not a multiple of 8 bytes (1 x 1 x 3 int16 samples,
+// frames 0, 1 and 3) next to 'binPath', open the result and read every frame back, so the
+// writer's layout and FrameFile::open's validation stay in step. Run by --convert.
+bool check_frame_file_round_trip(const std::string& binPath) {
+    const std::string csvPath = binPath + ".roundtrip.csv";
+    const std::string roundTripPath = binPath + ".roundtrip.bin";
+    const int frameNumbers[] = { 0, 1, 3 };
+    {
+        std::ofstream csv(csvPath);
+        for (int frameNumber : frameNumbers) {
+            for (int s = 0; s < 3; s++) {
+                csv << frameNumber << ",0,0," << s << "," << (frameNumber * 10 + s - 7) << "\n";
+            }
+        }
+    }
+
+    bool ok = FrameIO::convert_csv_to_binary(csvPath, roundTripPath, 1, 1, 3);
+    {
+        FrameIO::FrameFile file;
+        ok = ok && file.open(roundTripPath) && file.num_frames() == 3;
+        RadarData::RawFrame frame;
+        for (int frameNumber : frameNumbers) {
+            ok = ok && file.load_raw_frame(frameNumber, frame);
+            for (int s = 0; ok && s < 3; s++) {
+                ok = frame(0, 0, s) == frameNumber * 10 + s - 7;
+            }
+        }
+        ok = ok && !file.load_raw_frame(2, frame);
+    }
+    std::remove(csvPath.c_str());
+    std::remove(roundTripPath.c_str());
+    if (!ok) {
+        std::cerr << "Error: Frame file round trip failed; converted captures may not open" << std::endl;
+    }
+    return ok;
+}
+
+// Largest deviation of the Radix4 engine from Radix2 on one length-N input (random samples or
+// an impulse at index 1), relative to the largest Radix2 output magnitude
+template <typename T>
+double fft_engine_deviation(size_t N, bool inverse, bool impulse) {
+    std::mt19937 rng(static_cast<unsigned>(N) * 2 + (inverse ? 1 : 0));
+    std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+    std::vector<std::complex<T>> radix2(N), radix4(N);
+    for (size_t n = 0; n < N; n++) {
+        radix2[n] = impulse ? std::complex<T>(n == 1 ? T(1) : T(0), T(0))
+            : std::complex<T>(static_cast<T>(uniform(rng)), static_cast<T>(uniform(rng)));
+    }
+    radix4 = radix2;
+    const fftProcessing::BasicFftPlan<T>& plan = fftProcessing::get_fft_plan<T>(N);
+    plan.execute(radix2.data(), inverse, RadarConfig::FftEngine::Radix2);
+    plan.execute(radix4.data(), inverse, RadarConfig::FftEngine::Radix4);
+
+    double maxError = 0.0;
+    double maxMagnitude = 0.0;
+    for (size_t n = 0; n < N; n++) {
+        maxError = std::max(maxError, static_cast<double>(std::abs(radix4[n] - radix2[n])));
+        maxMagnitude = std::max(maxMagnitude, static_cast<double>(std::abs(radix2[n])));
+    }
+    return maxMagnitude > 0.0 ? maxError / maxMagnitude : maxError;
+}
+
+// Check the Radix4 engine against Radix2 on random and impulse inputs, forward and inverse,
+// in both precisions, including odd log2 lengths that start with a radix-2 stage:
+// RadarSignalProcessing --verify-fft
+int verify_fft_engines() {
+    constexpr double DOUBLE_TOLERANCE = 1e-12;
+    constexpr double FLOAT_TOLERANCE = 1e-5;
+    const size_t lengths[] = { 8, 32, 128, 256 };
+    double maxDouble = 0.0;
+    double maxFloat = 0.0;
+    for (size_t N : lengths) {
+        for (bool inverse : { false, true }) {
+            for (bool impulse : { false, true }) {
+                double errorD = fft_engine_deviation<double>(N, inverse, impulse);
+                double errorF = fft_engine_deviation<float>(N, inverse, impulse);
+                std::cout << "N=" << N << (inverse ? " inverse" : " forward") << (impulse ? " impulse" : " random")
+                    << ": double " << errorD << ", float " << errorF << std::endl;
+                maxDouble = std::max(maxDouble, errorD);
+                maxFloat = std::max(maxFloat, errorF);
+            }
+        }
+    }
+    std::cout << "Radix4 vs Radix2 max relative deviation: double " << maxDouble
+        << ", float " << maxFloat << std::endl;
+    return maxDouble <= DOUBLE_TOLERANCE && maxFloat <= FLOAT_TOLERANCE ? 0 : 1;
+}
+
+// Run steps 1-4 on one frame in double and in single precision and report how far
+// the float results deviate: RadarSignalProcessing --compare-precision
+int compare_precision(const RadarData::RawFrame& raw, const RadarConfig::Config& rconfig) {
+    RadarData::Frame frameD;
+    RadarData::FrameF frameF;
+    RadarData::MagnitudeMap magnitudeD;
+    RadarData::MagnitudeMapF magnitudeF;
+
+    RadarData::PeakList peaksD, peaksF;
+    RadarData::PeakSnaps snapsD;
+    RadarData::BasicPeakSnaps<float> snapsF;
+    std::vector<std::pair<double, double>> doaD, doaF;
+    std::cout << "-- double precision --" << std::endl;
+    process_frame(raw, frameD, rconfig, magnitudeD, peaksD, snapsD, doaD);
+    std::cout << "-- single precision --" << std::endl;
+    process_frame(raw, frameF, rconfig, magnitudeF, peaksF, snapsF, doaF);
+
+    // FFT output, relative to the largest double-precision magnitude
+    double maxError = 0.0;
+    double maxMagnitude = 0.0;
+    for (int r = 0; r < frameD.num_receivers(); r++) {
+        for (int c = 0; c < frameD.num_chirps(); c++) {
+            for (int s = 0; s < frameD.num_samples(); s++) {
+                std::complex<double> single(frameF(r, c, s).real(), frameF(r, c, s).imag());
+                maxError = std::max(maxError, std::abs(frameD(r, c, s) - single));
+                maxMagnitude = std::max(maxMagnitude, std::abs(frameD(r, c, s)));
+            }
+        }
+    }
+    std::cout << "FFT max abs deviation: " << maxError << ", relative to peak: "
+        << (maxMagnitude > 0.0 ? maxError / maxMagnitude : maxError) << std::endl;
+
+    // Detections present in both runs, compared snap by snap and angle by angle
+    std::map<std::tuple<int, int, int>, size_t> indexF;
+    for (size_t i = 0; i < peaksF.size(); i++) {
+        indexF.emplace(peaksF[i], i);
+    }
+    size_t common = 0;
+    size_t doaMismatches = 0;
+    double maxSnapError = 0.0;
+    double maxAngleError = 0.0;
+    double maxCosineError = 0.0;
+    auto direction_cosine = [](double azimuth, double elevation) {
+        return std::sin(azimuth * RadarConfig::PI / 180.0) * std::cos(elevation * RadarConfig::PI / 180.0);
+    };
+    for (size_t i = 0; i < peaksD.size(); i++) {
+        auto match = indexF.find(peaksD[i]);
+        if (match == indexF.end()) {
+            continue;
+        }
+        size_t j = match->second;
+        common++;
+        for (size_t r = 0; r < snapsD[i].size(); r++) {
+            std::complex<double> single(snapsF[j][r].real(), snapsF[j][r].imag());
+            double reference = std::abs(snapsD[i][r]);
+            double error = std::abs(snapsD[i][r] - single);
+            maxSnapError = std::max(maxSnapError, reference > 0.0 ? error / reference : error);
+        }
+        double angleError = std::max(std::abs(doaD[i].first - doaF[j].first), std::abs(doaD[i].second - doaF[j].second));
+        if (angleError > 0.0) {
+            doaMismatches++;
+        }
+        maxAngleError = std::max(maxAngleError, angleError);
+        // The array only resolves sin(azimuth) * cos(elevation); grid points sharing it tie
+        maxCosineError = std::max(maxCosineError,
+            std::abs(direction_cosine(doaD[i].first, doaD[i].second) - direction_cosine(doaF[j].first, doaF[j].second)));
+    }
+    std::cout << "Peaks double/single/common: " << peaksD.size() << "/" << peaksF.size() << "/" << common << std::endl;
+    std::cout << "Peak snap max relative deviation: " << maxSnapError << std::endl;
+    std::cout << "DOA mismatches: " << doaMismatches << " of " << common
+        << ", max angle deviation: " << maxAngleError << " deg"
+        << ", max direction cosine deviation: " << maxCosineError << std::endl;
+    return 0;
+}
+
+// Search the MUSIC spectrum of one frame's peaks exhaustively and coarse to fine, then of
+// synthetic snaps of known direction, and report how the two searches differ in time and
+// direction cosine error: RadarSignalProcessing --compare-music
+int compare_music_search(const RadarData::RawFrame& raw, const RadarConfig::Config& rconfig) {
+    RadarConfig::Config exhaustiveConfig = rconfig;
+    exhaustiveConfig.music_search = RadarConfig::MusicSearch::Exhaustive;
+    RadarConfig::Config refinedConfig = rconfig;
+    refinedConfig.music_search = RadarConfig::MusicSearch::CoarseToFine;
+
+    RadarData::Frame frame;
+    RadarData::MagnitudeMap magnitude;
+    RadarData::PeakList peakList;
+    RadarData::PeakSnaps peakSnaps;
+    std::vector<std::pair<double, double>> doaExhaustive, doaRefined;
+    process_frame(raw, frame, exhaustiveConfig, magnitude, peakList, peakSnaps, doaExhaustive);
+
+    MIMOSynthesis::VirtualArray virtualArray;
+    virtualArray.build(rconfig, frame.num_chirps());
+    DOAProcessing::SteeringTable exhaustiveTable(virtualArray.positions(), rconfig.wavelength,
+        RadarConfig::MUSIC_GRID_LIMIT_DEG, DOAProcessing::music_grid_step(exhaustiveConfig));
+    DOAProcessing::SteeringTable refinedTable(virtualArray.positions(), rconfig.wavelength,
+        RadarConfig::MUSIC_GRID_LIMIT_DEG, DOAProcessing::music_grid_step(refinedConfig));
+
+    auto time_search = [](const RadarData::PeakSnaps& snaps, const DOAProcessing::SteeringTable& table,
+        const RadarConfig::Config& config, std::vector<std::pair<double, double>>& results) {
+        auto start = std::chrono::high_resolution_clock::now();
+        DOAProcessing::compute_music_doa(snaps, table, results, /*num_sources=*/1, config);
+        std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+        return elapsed.count();
+    };
+    // The array only resolves sin(azimuth) * cos(elevation); angles sharing it tie
+    auto direction_cosine = [](double azimuth, double elevation) {
+        return std::sin(azimuth * RadarConfig::PI / 180.0) * std::cos(elevation * RadarConfig::PI / 180.0);
+    };
+
+    // Capture peaks: no ground truth, so only the agreement of the two searches
+    double exhaustiveTime = time_search(peakSnaps, exhaustiveTable, exhaustiveConfig, doaExhaustive);
+    double refinedTime = time_search(peakSnaps, refinedTable, refinedConfig, doaRefined);
+    double maxCosineDeviation = 0.0;
+    for (size_t i = 0; i < doaExhaustive.size() && i < doaRefined.size(); i++) {
+        maxCosineDeviation = std::max(maxCosineDeviation,
+            std::abs(direction_cosine(doaExhaustive[i].first, doaExhaustive[i].second)
+                - direction_cosine(doaRefined[i].first, doaRefined[i].second)));
+    }
+    std::cout << "Capture peaks: " << peakSnaps.size() << ", exhaustive " << exhaustiveTime
+        << " s, coarse-to-fine " << refinedTime << " s, max direction cosine deviation: "
+        << maxCosineDeviation << std::endl;
+
+    // Synthetic snaps: one noiseless source per snap at a known, off-grid direction
+    constexpr int NUM_DIRECTIONS = 500;
+    const int numElements = virtualArray.num_elements();
+    RadarData::PeakSnaps synthetic;
+    synthetic.resize(NUM_DIRECTIONS, numElements);
+    std::vector<double> truth(NUM_DIRECTIONS);
+    for (int d = 0; d < NUM_DIRECTIONS; d++) {
+        const double azimuth = -60.0 + 120.0 * (d + 0.5) / NUM_DIRECTIONS + 0.013 * d;
+        const double elevation = 0.0;
+        truth[d] = direction_cosine(azimuth, elevation);
+        exhaustiveTable.steer(azimuth, elevation, synthetic.data() + static_cast<size_t>(d) * numElements);
+    }
+    exhaustiveTime = time_search(synthetic, exhaustiveTable, exhaustiveConfig, doaExhaustive);
+    refinedTime = time_search(synthetic, refinedTable, refinedConfig, doaRefined);
+    double exhaustiveMean = 0.0, exhaustiveMax = 0.0, refinedMean = 0.0, refinedMax = 0.0;
+    for (int d = 0; d < NUM_DIRECTIONS; d++) {
+        double exhaustiveError = std::abs(direction_cosine(doaExhaustive[d].first, doaExhaustive[d].second) - truth[d]);
+        double refinedError = std::abs(direction_cosine(doaRefined[d].first, doaRefined[d].second) - truth[d]);
+        exhaustiveMean += exhaustiveError / NUM_DIRECTIONS;
+        refinedMean += refinedError / NUM_DIRECTIONS;
+        exhaustiveMax = std::max(exhaustiveMax, exhaustiveError);
+        refinedMax = std::max(refinedMax, refinedError);
+    }
+    std::cout << "Synthetic directions: " << NUM_DIRECTIONS << std::endl;
+    std::cout << "  exhaustive:     " << exhaustiveTime << " s, direction cosine error mean "
+        << exhaustiveMean << ", max " << exhaustiveMax << std::endl;
+    std::cout << "  coarse-to-fine: " << refinedTime << " s, direction cosine error mean "
+        << refinedMean << ", max " << refinedMax << std::endl;
+    return refinedMax <= exhaustiveMax ? 0 : 1;
+}
+
+int main(int argc, char* argv[]) {
     // Load radar configuration
 
     RadarConfig::Config rconfig = RadarConfig::load_config();
+    fftProcessing::set_fft_engine(rconfig.fft_engine);
+    Parallel::set_thread_count(rconfig.num_threads);
+    std::cout << "FFT SIMD level: " << fftProcessing::simd_level_name(fftProcessing::get_simd_level()) << std::endl;
+
+    if (argc >= 2 && std::string(argv[1]) == "--verify-fft") {
+        return verify_fft_engines();
+    }
+
+    // One-shot conversion: RadarSignalProcessing --convert radar_indexed.csv radar_indexed.bin
+    if (argc >= 2 && std::string(argv[1]) == "--convert") {
+        if (argc < 4) {
+            std::cerr << "Usage: " << argv[0] << " --convert <input.csv> <output.bin>" << std::endl;
+            return 1;
+        }
+        bool converted = FrameIO::convert_csv_to_binary(argv[2], argv[3],
+            rconfig.num_receivers, rconfig.num_chirps, rconfig.num_samples);
+        return converted && check_frame_file_round_trip(argv[3]) ? 0 : 1;
+    }
+
+    // Prefer the memory-mapped binary capture; fall back to streaming the CSV
+    FrameIO::FrameFile frameFile;
+    FrameIO::FrameReader frameReader(rconfig.num_receivers, rconfig.num_chirps, rconfig.num_samples);
+    if (frameFile.open("radar_indexed.bin")) {
+        std::cout << "Using binary capture radar_indexed.bin (" << frameFile.num_frames() << " frames)" << std::endl;
+    }
+    else if (!frameReader.open("radar_indexed.csv")) {
+        std::cerr << "Error: Could not open radar_indexed.csv" << std::endl;
+    }
+
+    // Equivalence check of the fused range stage against the three-pass path on the
+    // first frame: RadarSignalProcessing --verify-fused-range
+    if (argc >= 2 && std::string(argv[1]) == "--verify-fused-range") {
+        RadarData::Frame threePass;
+        int frameNumber;
+        bool loaded = frameFile.is_open() ? frameFile.load_frame(0, threePass)
+            : frameReader.next_frame(threePass, frameNumber);
+        if (!loaded) {
+            std::cerr << "Error: No frame available for the fused range check" << std::endl;
+            return 1;
+        }
+        RadarData::Frame fused = threePass;
+        fftProcessing::apply_hilbert_transform_samples(threePass);
+        fftProcessing::apply_fft1(threePass);
+        fftProcessing::apply_fused_range_fft(fused, rconfig.real_adc_input);
+
+        double maxError = 0.0;
+        double maxMagnitude = 0.0;
+        for (int r = 0; r < threePass.num_receivers(); r++) {
+            for (int c = 0; c < threePass.num_chirps(); c++) {
+                for (int s = 0; s < threePass.num_samples(); s++) {
+                    maxError = std::max(maxError, std::abs(threePass(r, c, s) - fused(r, c, s)));
+                    maxMagnitude = std::max(maxMagnitude, std::abs(threePass(r, c, s)));
+                }
+            }
+        }
+        double relativeError = maxMagnitude > 0.0 ? maxError / maxMagnitude : maxError;
+        std::cout << "Fused range FFT max abs error: " << maxError
+            << ", relative to peak: " << relativeError << std::endl;
+        return relativeError < 1e-9 ? 0 : 1;
+    }
+
+    if (argc >= 2 && std::string(argv[1]) == "--compare-precision") {
+        RadarData::RawFrame first;
+        int frameNumber;
+        bool loaded = frameFile.is_open() ? frameFile.load_raw_frame(0, first)
+            : frameReader.next_raw_frame(first, frameNumber);
+        if (!loaded) {
+            std::cerr << "Error: No frame available for the precision comparison" << std::endl;
+            return 1;
+        }
+        return compare_precision(first, rconfig);
+    }
+
+    if (argc >= 2 && std::string(argv[1]) == "--compare-music") {
+        RadarData::RawFrame first;
+        int frameNumber;
+        bool loaded = frameFile.is_open() ? frameFile.load_raw_frame(0, first)
+            : frameReader.next_raw_frame(first, frameNumber);
+        if (!loaded) {
+            std::cerr << "Error: No frame available for the MUSIC search comparison" << std::endl;
+            return 1;
+        }
+        return compare_music_search(first, rconfig);
+    }
 
     // Number of frames to process
     constexpr int NUM_FRAMES = 2;
 
+    // Frames reused across iterations so their storage is allocated once. Samples are
+    // kept as raw int16 and widened by the range FFT into 'frame' or 'frameF'.
+    RadarData::RawFrame rawFrame;
+    RadarData::Frame frame;
+    RadarData::FrameF frameF;
+    RadarData::MagnitudeMap magnitude;
+    RadarData::MagnitudeMapF magnitudeF;
+
     // Loop over each frame
     for (int frameIndex = 0; frameIndex < NUM_FRAMES; ++frameIndex) {
         std::cout << "Processing frame " << frameIndex + 1 << " of " << NUM_FRAMES << std::endl;
 
         // Initialize frame by reading data for the current frame
-        RadarData::Frame frame = RadarData::initialize_frame(
-            rconfig.num_receivers,
-            rconfig.num_chirps,
-            rconfig.num_samples,
-            frameIndex // Add this argument
-        );
+        if (frameFile.is_open()) {
+            if (!frameFile.load_raw_frame(frameIndex, rawFrame)) {
+                std::cerr << "Error: Frame " << frameIndex << " not found in radar_indexed.bin" << std::endl;
+                break;
+            }
+        }
+        else {
+            // Frames are read in file order; skip any numbered before frameIndex so the CSV
+            // path processes the same frame as the indexed lookup of the binary capture
+            int frameNumber = -1;
+            bool loaded = false;
+            while ((loaded = frameReader.next_raw_frame(rawFrame, frameNumber)) && frameNumber < frameIndex) {
+            }
+            if (!loaded || frameNumber != frameIndex) {
+                std::cerr << "Error: Frame " << frameIndex << " not found in radar_indexed.csv" << std::endl;
+                break;
+            }
+        }
 
         std::cout << "Data Initialized" << std::endl;
         // Calculate frame size in bytes
-        size_t frame_size = RadarData::frame_size_bytes(frame);
+        size_t frame_size = RadarData::frame_size_bytes(rawFrame);
         std::cout << "Frame size in bytes: " << frame_size << std::endl;
 
-        //*********************STEP 1 FFT PROCESSING *******************
-        auto start = std::chrono::high_resolution_clock::now();
-        fftProcessing::fftProcessPipeline(frame);
-        auto end = std::chrono::high_resolution_clock::now();
-        std::chrono::duration<double> elapsed = end - start;
-        std::cout << "Time taken for fftProcessPipeline: " << elapsed.count() << " seconds" << std::endl;
-
-        //*********************STEP 2 PEAK DETECTION  *******************
-        // Declare necessary variables for peak detection
-        RadarData::NCI nci;
-        RadarData::FoldedNCI foldedNci;
-        RadarData::NoiseEstimation noiseEstimation;
-        RadarData::ThresholdingMap thresholdingMap;
         RadarData::PeakList peakList;
-
-        start = std::chrono::high_resolution_clock::now();
-        PeakDetection::cfar_peak_detection(frame, nci, foldedNci, noiseEstimation, thresholdingMap, peakList);
-        end = std::chrono::high_resolution_clock::now();
-        elapsed = end - start;
-        std::cout << "Number of peaks detected: " << peakList.size() << std::endl;
-        std::cout << "Time taken for peakDetection: " << elapsed.count() << " seconds" << std::endl;
-
-        //*********************STEP 3 MIMO SYNTHESIS PEAK SNAP DETECTION  *******************
         RadarData::PeakSnaps peakSnaps;
-
-        start = std::chrono::high_resolution_clock::now();
-        MIMOSynthesis::synthesize_peaks(peakList, frame, peakSnaps);
-        end = std::chrono::high_resolution_clock::now();
-        elapsed = end - start;
-        std::cout << "Time taken for MIMO synthesis: " << elapsed.count() << " seconds" << std::endl;
-
-        //*********************STEP 4 DOA PROCESSING  *******************
         std::vector<std::pair<double, double>> doaResults;
-
-        start = std::chrono::high_resolution_clock::now();
-        DOAProcessing::compute_music_doa(peakSnaps, doaResults, /*num_sources=*/1);
-        end = std::chrono::high_resolution_clock::now();
-        elapsed = end - start;
-        std::cout << "Time taken for DOA processing: " << elapsed.count() << " seconds" << std::endl;
+        if (rconfig.precision == RadarConfig::SamplePrecision::Single) {
+            // Steps 1-4 in single precision; the snaps are widened for the target stages
+            RadarData::BasicPeakSnaps<float> peakSnapsF;
+            process_frame(rawFrame, frameF, rconfig, magnitudeF, peakList, peakSnapsF, doaResults);
+            widen_peak_snaps(peakSnapsF, peakSnaps);
+        }
+        else {
+            process_frame(rawFrame, frame, rconfig, magnitude, peakList, peakSnaps, doaResults);
+        }
 
         // Output DOA results for the current frame
         std::cout << "DOA Results (Azimuth, Elevation) for frame " << frameIndex + 1 << ":" <<doaResults.size()<<std::endl;
@@ -85,7 +479,13 @@ int main() {
         }
         std::cout << "peaksnap size = " << peakSnaps.size() << std::endl;
         //*********************STEP 5 TARGET DETECTION *******************
-        TargetProcessing::TargetList targetList = TargetProcessing::detect_targets(peakSnaps, doaResults);
+        // Target strengths are read from the magnitude map computed for CFAR
+        auto detect_targets = [&]() {
+            return rconfig.precision == RadarConfig::SamplePrecision::Single
+                ? TargetProcessing::detect_targets(peakSnaps, doaResults, peakList, magnitudeF)
+                : TargetProcessing::detect_targets(peakSnaps, doaResults, peakList, magnitude);
+        };
+        TargetProcessing::TargetList targetList = detect_targets();
 
         //std::cout << "Targets detected:" << std::endl;
         /*for (const auto& target : targetList) {
@@ -104,7 +504,7 @@ int main() {
     double receiverGain = 10.0;    // Example: 10 dB
 
     // Detect targets
-    TargetProcessing::TargetList targets = TargetProcessing::detect_targets(peakSnaps, doaResults);
+    TargetProcessing::TargetList targets = detect_targets();
 
     // Estimate RCS for each target
     RCSEstimation::estimate_rcs(targets, transmittedPower, transmitterGain, receiverGain);
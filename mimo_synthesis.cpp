@@ -3,34 +3,157 @@
 #include <iostream>
 #include <vector>
 #include <complex>
+#include <algorithm>
+#include <cmath>
 
 namespace MIMOSynthesis {
-    void synthesize_peaks(const RadarData::PeakList& peakList, const RadarData::Frame& frame, RadarData::PeakSnaps& peakSnaps) {
-        // Clear the output PeakSnaps
-        peakSnaps.clear();
-
-        // Iterate over the Peak List
-        for (const auto& peak : peakList) {
-            int receiver = std::get<0>(peak);
-            int chirp = std::get<1>(peak);
-            int sample = std::get<2>(peak);
-
-            // Validate indices
-            if (receiver < 0 || receiver >= frame.size() ||
-                chirp < 0 || chirp >= frame[0].size() ||
-                sample < 0 || sample >= frame[0][0].size()) {
-                std::cerr << "Invalid peak indices: (" << receiver << ", " << chirp << ", " << sample << ")" << std::endl;
-                continue;
+    namespace {
+        // Gather the receiver samples of every valid peak into one row of peakSnaps each; chirps
+        // receives the chirp (Doppler bin) of each row
+        template <typename T>
+        void gather_snaps(const RadarData::PeakList& peakList, const RadarData::BasicRadarCube<T>& frame,
+            RadarData::BasicPeakSnaps<T>& peakSnaps, std::vector<int>& chirps) {
+            // Offset of each valid peak cell within a receiver plane, reused across frames
+            thread_local std::vector<size_t> offsets;
+            offsets.clear();
+            offsets.reserve(peakList.size());
+            chirps.clear();
+
+            // Iterate over the Peak List
+            for (const auto& peak : peakList) {
+                int receiver = std::get<0>(peak);
+                int chirp = std::get<1>(peak);
+                int sample = std::get<2>(peak);
+
+                // Validate indices
+                if (receiver < 0 || receiver >= frame.num_receivers() ||
+                    chirp < 0 || chirp >= frame.num_chirps() ||
+                    sample < 0 || sample >= frame.num_samples()) {
+                    std::cerr << "Invalid peak indices: (" << receiver << ", " << chirp << ", " << sample << ")" << std::endl;
+                    continue;
+                }
+                offsets.push_back(chirp * frame.chirp_stride() + sample * frame.sample_stride());
+                chirps.push_back(chirp);
             }
 
-            // Combine data across all receivers for the given chirp and sample
-            std::vector<std::complex<double>> combinedData;
-            for (int r = 0; r < frame.size(); ++r) {
-                combinedData.push_back(frame[r][chirp][sample]);
+            // One snap row per valid peak, sized once for the frame
+            const size_t num_peaks = offsets.size();
+            const size_t num_receivers = static_cast<size_t>(frame.num_receivers());
+            peakSnaps.resize(num_peaks, num_receivers);
+            std::complex<T>* snaps = peakSnaps.data();
+            const std::complex<T>* source = frame.data();
+
+            if (frame.receiver_stride() == 1) {
+                // Receiver vectors are contiguous in the cube: copy each one whole
+                for (size_t p = 0; p < num_peaks; ++p) {
+                    std::copy(source + offsets[p], source + offsets[p] + num_receivers, snaps + p * num_receivers);
+                }
+                return;
             }
 
-            // Store the combined data as a Peak Snap
-            peakSnaps.push_back(combinedData);
+            // Gather one receiver plane at a time across all peaks
+            for (size_t r = 0; r < num_receivers; ++r) {
+                const std::complex<T>* plane = source + r * frame.receiver_stride();
+                std::complex<T>* column = snaps + r;
+                for (size_t p = 0; p < num_peaks; ++p) {
+                    column[p * num_receivers] = plane[offsets[p]];
+                }
+            }
         }
     }
+
+    template <typename T>
+    void BasicVirtualArray<T>::build(const RadarConfig::Config& rconfig, int num_doppler_bins) {
+        num_transmitters_ = std::max(rconfig.num_transmitters, 1);
+        num_receivers_ = std::max(rconfig.num_receivers, 0);
+        num_doppler_bins_ = std::max(num_doppler_bins, 0);
+
+        // Uniform linear transmit and receive arrays along the horizontal axis
+        positions_.clear();
+        for (int t = 0; t < num_transmitters_; t++) {
+            for (int r = 0; r < num_receivers_; r++) {
+                positions_.push_back({ t * rconfig.tx_antenna_spacing + r * rconfig.antenna_spacing, 0.0 });
+            }
+        }
+
+        // exp(+j * 2*pi * t * k / (NT * N)) for signed bin k, repeated over the receivers of t
+        const int num_elements = this->num_elements();
+        correction_.resize(static_cast<size_t>(num_doppler_bins_) * num_elements);
+        for (int k = 0; k < num_doppler_bins_; k++) {
+            const int signed_bin = k < (num_doppler_bins_ + 1) / 2 ? k : k - num_doppler_bins_;
+            std::complex<T>* row = correction_.data() + static_cast<size_t>(k) * num_elements;
+            for (int t = 0; t < num_transmitters_; t++) {
+                const double phase = 2.0 * RadarConfig::PI * t * signed_bin / (static_cast<double>(num_transmitters_) * num_doppler_bins_);
+                const std::complex<T> factor(static_cast<T>(std::cos(phase)), static_cast<T>(std::sin(phase)));
+                std::fill(row + t * num_receivers_, row + (t + 1) * num_receivers_, factor);
+            }
+        }
+    }
+
+    bool deinterleave_tdm(const RadarData::RawFrame& raw, int num_transmitters, RadarData::RawFrame& virtualRaw) {
+        const int num_receivers = raw.num_receivers();
+        const int num_chirps = raw.num_chirps();
+        const int num_samples = raw.num_samples();
+        if (num_transmitters < 1 || num_chirps % num_transmitters != 0) {
+            std::cerr << "Cannot deinterleave " << num_chirps << " chirps over " << num_transmitters << " transmitters" << std::endl;
+            return false;
+        }
+
+        const int chirps_per_tx = num_chirps / num_transmitters;
+        virtualRaw.resize(num_transmitters * num_receivers, chirps_per_tx, num_samples);
+        for (int t = 0; t < num_transmitters; t++) {
+            for (int r = 0; r < num_receivers; r++) {
+                for (int c = 0; c < chirps_per_tx; c++) {
+                    const int16_t* source = raw.samples(r, c * num_transmitters + t);
+                    std::copy(source, source + num_samples, &virtualRaw(t * num_receivers + r, c, 0));
+                }
+            }
+        }
+        return true;
+    }
+
+    template <typename T>
+    void synthesize_peaks(const RadarData::PeakList& peakList, const RadarData::BasicRadarCube<T>& frame,
+        RadarData::BasicPeakSnaps<T>& peakSnaps) {
+        thread_local std::vector<int> chirps;
+        gather_snaps(peakList, frame, peakSnaps, chirps);
+    }
+
+    template <typename T>
+    void synthesize_peaks(const RadarData::PeakList& peakList, const RadarData::BasicRadarCube<T>& frame,
+        const BasicVirtualArray<T>& array, RadarData::BasicPeakSnaps<T>& peakSnaps) {
+        if (frame.num_receivers() != array.num_elements() || frame.num_chirps() != array.num_doppler_bins()) {
+            std::cerr << "Frame of " << frame.num_receivers() << " receivers x " << frame.num_chirps()
+                << " chirps does not match the virtual array" << std::endl;
+            peakSnaps.clear();
+            return;
+        }
+
+        thread_local std::vector<int> chirps;
+        gather_snaps(peakList, frame, peakSnaps, chirps);
+        if (array.num_transmitters() == 1) {
+            return; // A single transmitter needs no correction
+        }
+
+        // Doppler-induced TDM phase: one table row per peak
+        const size_t num_elements = peakSnaps.num_channels();
+        for (size_t p = 0; p < peakSnaps.size(); ++p) {
+            std::complex<T>* snap = peakSnaps[p].data();
+            const std::complex<T>* factors = array.correction(chirps[p]);
+            for (size_t v = 0; v < num_elements; ++v) {
+                snap[v] *= factors[v];
+            }
+        }
+    }
+
+    template void synthesize_peaks<float>(const RadarData::PeakList& peakList, const RadarData::FrameF& frame,
+        RadarData::BasicPeakSnaps<float>& peakSnaps);
+    template void synthesize_peaks<double>(const RadarData::PeakList& peakList, const RadarData::Frame& frame,
+        RadarData::BasicPeakSnaps<double>& peakSnaps);
+    template void synthesize_peaks<float>(const RadarData::PeakList& peakList, const RadarData::FrameF& frame,
+        const VirtualArrayF& array, RadarData::BasicPeakSnaps<float>& peakSnaps);
+    template void synthesize_peaks<double>(const RadarData::PeakList& peakList, const RadarData::Frame& frame,
+        const VirtualArray& array, RadarData::BasicPeakSnaps<double>& peakSnaps);
+    template class BasicVirtualArray<float>;
+    template class BasicVirtualArray<double>;
 }
@@ -2,10 +2,71 @@
 #define MIMO_SYNTHESIS_HPP
 
 #include "datatypes.hpp"
+#include "config.hpp"
+#include <complex>
+#include <vector>
 
 namespace MIMOSynthesis {
-    // Function to perform MIMO synthesis
-    void synthesize_peaks(const RadarData::PeakList& peakList, const RadarData::Frame& frame, RadarData::PeakSnaps& peakSnaps);
+    // Position of one virtual element in the array plane, in meters
+    struct ElementPosition {
+        double horizontal;
+        double vertical;
+    };
+
+    // TDM-MIMO virtual array: element v = tx * NR + rx, placed at the sum of its transmit and
+    // receive antenna positions. Transmitter t fires t chirp periods after transmitter 0, so at
+    // signed Doppler bin k of N the samples of a moving target are rotated by
+    // exp(-j * 2*pi * t * k / (NT * N)); the array holds the inverse rotation as one row of
+    // NT * NR factors per Doppler bin.
+    // Instantiated for float and double.
+    template <typename T>
+    class BasicVirtualArray {
+    public:
+        BasicVirtualArray() = default;
+        BasicVirtualArray(const RadarConfig::Config& rconfig, int num_doppler_bins) { build(rconfig, num_doppler_bins); }
+
+        // Lay out the elements from the antenna counts and spacings of rconfig and tabulate the
+        // phase correction for num_doppler_bins bins (the chirps per transmitter)
+        void build(const RadarConfig::Config& rconfig, int num_doppler_bins);
+
+        int num_transmitters() const { return num_transmitters_; }
+        int num_receivers() const { return num_receivers_; }
+        int num_elements() const { return num_transmitters_ * num_receivers_; }
+        int num_doppler_bins() const { return num_doppler_bins_; }
+        const std::vector<ElementPosition>& positions() const { return positions_; }
+
+        // num_elements() correction factors for one Doppler bin
+        const std::complex<T>* correction(int doppler_bin) const {
+            return correction_.data() + static_cast<size_t>(doppler_bin) * num_elements();
+        }
+
+    private:
+        int num_transmitters_ = 0;
+        int num_receivers_ = 0;
+        int num_doppler_bins_ = 0;
+        std::vector<ElementPosition> positions_;
+        std::vector<std::complex<T>> correction_;
+    };
+
+    using VirtualArray = BasicVirtualArray<double>;
+    using VirtualArrayF = BasicVirtualArray<float>;
+
+    // Split a TDM capture, whose chirp c was sent by transmitter c % num_transmitters, into a
+    // cube of num_transmitters * NR virtual receivers (tx-major) by C / num_transmitters chirps.
+    // Returns false if the chirps do not divide evenly.
+    bool deinterleave_tdm(const RadarData::RawFrame& raw, int num_transmitters, RadarData::RawFrame& virtualRaw);
+
+    // Function to perform MIMO synthesis, instantiated for Frame and FrameF: gathers the receiver
+    // samples of every valid peak cell into one row of peakSnaps, resized once per call
+    template <typename T>
+    void synthesize_peaks(const RadarData::PeakList& peakList, const RadarData::BasicRadarCube<T>& frame,
+        RadarData::BasicPeakSnaps<T>& peakSnaps);
+
+    // Same over a deinterleaved TDM frame: each snap spans the virtual array and is multiplied by
+    // the correction row of its Doppler bin
+    template <typename T>
+    void synthesize_peaks(const RadarData::PeakList& peakList, const RadarData::BasicRadarCube<T>& frame,
+        const BasicVirtualArray<T>& array, RadarData::BasicPeakSnaps<T>& peakSnaps);
 }
 
 #endif // MIMO_SYNTHESIS_HPP
@@ -1,71 +1,774 @@
 #include "peak_detection.hpp"
+#include <algorithm> // Include for std::min and std::max
 #include <cmath> // Include for std::abs
+#include <cstdint>
+#include <iostream>
 #include <tuple> // Include for std::make_tuple
+#include <vector>
 #include "config.hpp"
+#include "thread_pool.hpp"
 
-namespace PeakDetection {
-    // Function to perform 2D CFAR-like peak detection
-    void cfar_peak_detection(const RadarData::Frame& frame, RadarData::NCI& nci, RadarData::FoldedNCI& foldedNci,
-        RadarData::NoiseEstimation& noiseEstimation, RadarData::ThresholdingMap& thresholdingMap,
-        RadarData::PeakList& peakList) {
-        int num_receivers = frame.size();
-        int num_chirps = frame[0].size();
-        int num_samples = frame[0][0].size();
-
-        // Initialize the output structures
-        nci.resize(num_chirps, std::vector<RadarData::Real>(num_samples, 0));
-        foldedNci.resize(num_chirps, std::vector<RadarData::Real>(num_samples, 0));
-        noiseEstimation.resize(num_chirps, std::vector<RadarData::Real>(num_samples, 0));
-        thresholdingMap.resize(num_chirps, std::vector<RadarData::Real>(num_samples, 0));
+// SSE2 is part of the x86-64 baseline (and of MSVC's default x86 target), so the CFAR
+// kernels use it without the runtime dispatch the FFT stages need for AVX
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RSP_CFAR_SSE2 1
+#else
+#define RSP_CFAR_SSE2 0
+#endif
 
-        // CFAR parameters
-        
-        double alpha = RadarConfig::TRAINING_CELLS  * (std::pow(RadarConfig::FALSE_ALARM_RATE, -1.0 / RadarConfig::TRAINING_CELLS) - 1);
+namespace PeakDetection {
+    namespace {
+        // Cells [c_begin, c_end) x [s_begin, s_end) of one receiver plane, the unit of parallel work
+        struct Tile {
+            int c_begin, c_end;
+            int s_begin, s_end;
+        };
 
-        // Perform CFAR detection for each receiver
-        for (int r = 0; r < num_receivers; r++) {
-            for (int c = 0; c < num_chirps; c++) {
-                for (int s = 0; s < num_samples; s++) {
-                    double magnitude = std::abs(frame[r][c][s]);
+        // Noise estimates (or, for cell averaging, training sums) are written per tile into a
+        // plane of one value per cell in chirp-major order. Every estimator excludes the guard
+        // box around the cell under test and clips both boxes to the map. Plane-wide tables are
+        // built once per receiver before the tiles run.
 
-                    // Calculate noise level using training cells in both Doppler and range dimensions
-                    double noise_level = 0.0;
-                    int training_count = 0;
+        // Direct: walk the training window of every cell
+        template <typename T>
+        void training_sums_direct(const RadarData::BasicMagnitudeMap<T>& magnitude, int r, int training, int guard,
+            const Tile& tile, std::vector<double>& sums) {
+            const int num_chirps = magnitude.num_chirps();
+            const int num_samples = magnitude.num_samples();
 
-                    for (int tc = -RadarConfig::TRAINING_CELLS; tc <= RadarConfig::TRAINING_CELLS; tc++) {
-                        for (int ts = -RadarConfig::TRAINING_CELLS; ts <= RadarConfig::TRAINING_CELLS; ts++) {
-                            if ((tc == 0 && ts == 0) ||
-                                (std::abs(tc) <= RadarConfig::GUARD_CELLS && std::abs(ts) <= RadarConfig::GUARD_CELLS)) {
+            for (int c = tile.c_begin; c < tile.c_end; c++) {
+                for (int s = tile.s_begin; s < tile.s_end; s++) {
+                    double noise_level = 0;
+                    for (int tc = -training; tc <= training; tc++) {
+                        for (int ts = -training; ts <= training; ts++) {
+                            if ((tc == 0 && ts == 0) || (std::abs(tc) <= guard && std::abs(ts) <= guard)) {
                                 continue; // Skip guard cells and the cell under test
                             }
 
                             int doppler_index = c + tc;
                             int range_index = s + ts;
-
                             if (doppler_index >= 0 && doppler_index < num_chirps &&
                                 range_index >= 0 && range_index < num_samples) {
-                                noise_level += std::abs(frame[r][doppler_index][range_index]);
-                                training_count++;
+                                noise_level += magnitude(r, doppler_index, range_index);
                             }
                         }
                     }
+                    sums[static_cast<size_t>(c) * num_samples + s] = noise_level;
+                }
+            }
+        }
+
+        // Sum over the inclusive box [c0, c1] x [s0, s1] of a summed-area table; the bounds must
+        // already be clamped to the map
+        inline double box_sum(const std::vector<double>& table, size_t stride, int c0, int c1, int s0, int s1) {
+            const double* top = table.data() + static_cast<size_t>(c0) * stride;
+            const double* bottom = table.data() + static_cast<size_t>(c1 + 1) * stride;
+            return bottom[s1 + 1] - bottom[s0] - top[s1 + 1] + top[s0];
+        }
+
+        // (C + 1) x (S + 1) summed-area table of one receiver with a zero first row and column, so
+        // each box is four lookups. Accumulated in double so the box differences stay accurate for
+        // float maps too.
+        template <typename T>
+        void build_summed_area_table(const RadarData::BasicMagnitudeMap<T>& magnitude, int r, std::vector<double>& table) {
+            const int num_chirps = magnitude.num_chirps();
+            const int num_samples = magnitude.num_samples();
+            const size_t stride = static_cast<size_t>(num_samples) + 1;
+
+            table.assign((static_cast<size_t>(num_chirps) + 1) * stride, 0.0);
+
+            for (int c = 0; c < num_chirps; c++) {
+                const T* magnitudeRow = magnitude.row(r, c);
+                const double* above = table.data() + static_cast<size_t>(c) * stride;
+                double* row = table.data() + static_cast<size_t>(c + 1) * stride;
+                double running = 0;
+                for (int s = 0; s < num_samples; s++) {
+                    running += magnitudeRow[s];
+                    row[s + 1] = above[s + 1] + running;
+                }
+            }
+        }
+
+        // IntegralImage: outer box minus guard box from the summed-area table
+        inline void training_sums_integral(const std::vector<double>& table, int num_chirps, int num_samples,
+            int training, int guard, const Tile& tile, std::vector<double>& sums) {
+            const size_t stride = static_cast<size_t>(num_samples) + 1;
+
+            for (int c = tile.c_begin; c < tile.c_end; c++) {
+                const int c0 = std::max(c - training, 0), c1 = std::min(c + training, num_chirps - 1);
+                const int gc0 = std::max(c - guard, 0), gc1 = std::min(c + guard, num_chirps - 1);
+                double* sumRow = sums.data() + static_cast<size_t>(c) * num_samples;
+                for (int s = tile.s_begin; s < tile.s_end; s++) {
+                    const int s0 = std::max(s - training, 0), s1 = std::min(s + training, num_samples - 1);
+                    const int gs0 = std::max(s - guard, 0), gs1 = std::min(s + guard, num_samples - 1);
+                    sumRow[s] = box_sum(table, stride, c0, c1, s0, s1) - box_sum(table, stride, gc0, gc1, gs0, gs1);
+                }
+            }
+        }
+
+        // Running sum of half-width 'half' along one row: out[s] = sum of in[s - half .. s + half]
+        // clipped to the row. One add and one subtract per sample.
+        template <typename T>
+        void sliding_row_sum(const T* in, int n, int half, double* out) {
+            // Window [s - half, s + half] clipped to [0, n - 1]; the edges only grow or shrink it
+            const int head = std::min(half, n);
+            double running = 0;
+            for (int s = 0; s < head; s++) {
+                running += in[s];
+            }
+            int s = 0;
+            for (; s < n && s + half < n && s - half < 0; s++) {
+                running += in[s + half];
+                out[s] = running;
+            }
+            for (; s + half < n; s++) {
+                running += in[s + half];
+                out[s] = running;
+                running -= in[s - half];
+            }
+            for (; s < n; s++) {
+                out[s] = running;
+                if (s - half >= 0) {
+                    running -= in[s - half];
+                }
+            }
+        }
+
+        // SlidingWindow, range pass for chirps [c_begin, c_end): running sums of half-width T and
+        // G along every chirp, stored as two C x S planes in rowSums
+        template <typename T>
+        void sliding_range_pass(const RadarData::BasicMagnitudeMap<T>& magnitude, int r, int training, int guard,
+            int c_begin, int c_end, std::vector<double>& rowSums) {
+            const int num_samples = magnitude.num_samples();
+            const size_t cells = static_cast<size_t>(magnitude.num_chirps()) * num_samples;
+            for (int c = c_begin; c < c_end; c++) {
+                const size_t offset = static_cast<size_t>(c) * num_samples;
+                sliding_row_sum(magnitude.row(r, c), num_samples, training, rowSums.data() + offset);
+                sliding_row_sum(magnitude.row(r, c), num_samples, guard, rowSums.data() + cells + offset);
+            }
+        }
+
+        // SlidingWindow, Doppler pass: running column sums of the range sums down the tile, adding
+        // the entering chirp and subtracting the leaving one
+        inline void training_sums_sliding(const std::vector<double>& rowSums, int num_chirps, int num_samples,
+            int training, int guard, const Tile& tile, std::vector<double>& sums) {
+            const size_t cells = static_cast<size_t>(num_chirps) * num_samples;
+            const int width = tile.s_end - tile.s_begin;
+            const double* outerRows = rowSums.data() + tile.s_begin;
+            const double* guardRows = rowSums.data() + cells + tile.s_begin;
+
+            thread_local std::vector<double> columns;
+            columns.assign(2 * static_cast<size_t>(width), 0.0);
+            double* outerColumn = columns.data();
+            double* guardColumn = columns.data() + width;
+
+            auto add_row = [width](double* column, const double* row) {
+                for (int s = 0; s < width; s++) column[s] += row[s];
+            };
+            auto subtract_row = [width](double* column, const double* row) {
+                for (int s = 0; s < width; s++) column[s] -= row[s];
+            };
+
+            // Window of the first chirp, less the rows the loop adds on entry
+            for (int c = std::max(tile.c_begin - training, 0); c < std::min(tile.c_begin + training, num_chirps); c++) {
+                add_row(outerColumn, outerRows + static_cast<size_t>(c) * num_samples);
+            }
+            for (int c = std::max(tile.c_begin - guard, 0); c < std::min(tile.c_begin + guard, num_chirps); c++) {
+                add_row(guardColumn, guardRows + static_cast<size_t>(c) * num_samples);
+            }
+
+            for (int c = tile.c_begin; c < tile.c_end; c++) {
+                if (c + training < num_chirps) {
+                    add_row(outerColumn, outerRows + static_cast<size_t>(c + training) * num_samples);
+                }
+                if (c + guard < num_chirps) {
+                    add_row(guardColumn, guardRows + static_cast<size_t>(c + guard) * num_samples);
+                }
+
+                double* sumRow = sums.data() + static_cast<size_t>(c) * num_samples + tile.s_begin;
+                for (int s = 0; s < width; s++) {
+                    sumRow[s] = outerColumn[s] - guardColumn[s];
+                }
+
+                if (c - training >= 0) {
+                    subtract_row(outerColumn, outerRows + static_cast<size_t>(c - training) * num_samples);
+                }
+                if (c - guard >= 0) {
+                    subtract_row(guardColumn, guardRows + static_cast<size_t>(c - guard) * num_samples);
+                }
+            }
+        }
+
+        // Training cells of (c, s): the clipped window minus the clipped guard box
+        inline int training_cell_count(int c, int s, int num_chirps, int num_samples, int training, int guard) {
+            const int c_count = std::min(c + training, num_chirps - 1) - std::max(c - training, 0) + 1;
+            const int gc_count = std::min(c + guard, num_chirps - 1) - std::max(c - guard, 0) + 1;
+            const int s_count = std::min(s + training, num_samples - 1) - std::max(s - training, 0) + 1;
+            const int gs_count = std::min(s + guard, num_samples - 1) - std::max(s - guard, 0) + 1;
+            return c_count * s_count - gc_count * gs_count;
+        }
+
+        // GreatestOf / SmallestOf over interior cells [begin, end) of one chirp: the larger (or
+        // smaller) of the leading and lagging half sums from the column prefix rows, times 'scale'.
+        // Two cells per SSE2 instruction; the scalar tail picks the same operand on ties and NaNs.
+        inline void split_window_interior(const double* outer, const double* inner, int training, int guard,
+            bool greatest, double scale, int begin, int end, double* estimateRow) {
+            int s = begin;
+#if RSP_CFAR_SSE2
+            const __m128d scaleVec = _mm_set1_pd(scale);
+            for (; s + 2 <= end; s += 2) {
+                const __m128d lead = _mm_sub_pd(
+                    _mm_sub_pd(_mm_loadu_pd(outer + s + 1), _mm_loadu_pd(outer + s - training)),
+                    _mm_sub_pd(_mm_loadu_pd(inner + s + 1), _mm_loadu_pd(inner + s - guard)));
+                const __m128d lag = _mm_sub_pd(
+                    _mm_sub_pd(_mm_loadu_pd(outer + s + training + 1), _mm_loadu_pd(outer + s)),
+                    _mm_sub_pd(_mm_loadu_pd(inner + s + guard + 1), _mm_loadu_pd(inner + s)));
+                const __m128d pick = greatest ? _mm_max_pd(lead, lag) : _mm_min_pd(lead, lag);
+                _mm_storeu_pd(estimateRow + s, _mm_mul_pd(pick, scaleVec));
+            }
+#endif
+            for (; s < end; s++) {
+                const double lead = (outer[s + 1] - outer[s - training]) - (inner[s + 1] - inner[s - guard]);
+                const double lag = (outer[s + training + 1] - outer[s]) - (inner[s + guard + 1] - inner[s]);
+                estimateRow[s] = (greatest ? std::max(lag, lead) : std::min(lag, lead)) * scale;
+            }
+        }
+
+        // GreatestOf / SmallestOf: the window is split along range into the leading (s' <= s) and
+        // lagging (s' >= s) halves, each averaged on its own. The Doppler-only column s' = s is
+        // shared, so together the halves cover every training cell, as cell averaging does. A
+        // half with no columns beyond s (at the map edge) falls back to the other one.
+        //
+        // Each chirp first reduces the summed-area table to two column prefix rows, over the
+        // window's and the guard box's chirps. Interior cells then have fixed offsets into those
+        // rows and equal half counts and run through split_window_interior; only the 'training'
+        // cells at each map edge take the clamped scalar path.
+        inline void split_window_estimates(const std::vector<double>& table, int num_chirps, int num_samples,
+            int training, int guard, bool greatest, const Tile& tile, std::vector<double>& estimates) {
+            const size_t stride = static_cast<size_t>(num_samples) + 1;
+            thread_local std::vector<double> prefixes;
+            prefixes.resize(2 * stride);
+            // outer[x] / inner[x]: sum of columns [0, x) over the window's / guard box's chirps
+            double* outer = prefixes.data();
+            double* inner = prefixes.data() + stride;
+
+            // Prefix columns the tile reads, and the cells whose halves are not clipped
+            const int x0 = std::max(tile.s_begin - training, 0);
+            const int x1 = std::min(tile.s_end + training, num_samples);
+            const int interior_begin = std::min(std::max(tile.s_begin, training), tile.s_end);
+            const int interior_end = std::max(std::min(tile.s_end, num_samples - training), interior_begin);
+
+            for (int c = tile.c_begin; c < tile.c_end; c++) {
+                const int c0 = std::max(c - training, 0), c1 = std::min(c + training, num_chirps - 1);
+                const int gc0 = std::max(c - guard, 0), gc1 = std::min(c + guard, num_chirps - 1);
+                const int rows = c1 - c0 + 1, guard_rows = gc1 - gc0 + 1;
+                double* estimateRow = estimates.data() + static_cast<size_t>(c) * num_samples;
+
+                const double* top = table.data() + static_cast<size_t>(c0) * stride;
+                const double* bottom = table.data() + static_cast<size_t>(c1 + 1) * stride;
+                const double* guardTop = table.data() + static_cast<size_t>(gc0) * stride;
+                const double* guardBottom = table.data() + static_cast<size_t>(gc1 + 1) * stride;
+                for (int x = x0; x <= x1; x++) {
+                    outer[x] = bottom[x] - top[x];
+                    inner[x] = guardBottom[x] - guardTop[x];
+                }
+
+                // Edge cells: clamp both halves to the map
+                auto edge_estimate = [&](int s) {
+                    const int lead0 = std::max(s - training, 0), guard_lead0 = std::max(s - guard, 0);
+                    const int lag1 = std::min(s + training, num_samples - 1), guard_lag1 = std::min(s + guard, num_samples - 1);
+                    const double lead_sum = (outer[s + 1] - outer[lead0]) - (inner[s + 1] - inner[guard_lead0]);
+                    const double lag_sum = (outer[lag1 + 1] - outer[s]) - (inner[guard_lag1 + 1] - inner[s]);
+                    const int lead_count = rows * (s + 1 - lead0) - guard_rows * (s + 1 - guard_lead0);
+                    const int lag_count = rows * (lag1 + 1 - s) - guard_rows * (guard_lag1 + 1 - s);
+
+                    const bool has_lead = s > lead0 && lead_count > 0;
+                    const bool has_lag = lag1 > s && lag_count > 0;
+                    const double lead = lead_count > 0 ? lead_sum / lead_count : 0.0;
+                    const double lag = lag_count > 0 ? lag_sum / lag_count : 0.0;
+                    if (!has_lead || !has_lag) {
+                        estimateRow[s] = has_lead ? lead : lag;
+                    }
+                    else {
+                        estimateRow[s] = greatest ? std::max(lead, lag) : std::min(lead, lag);
+                    }
+                };
+                for (int s = tile.s_begin; s < interior_begin; s++) {
+                    edge_estimate(s);
+                }
+
+                // Interior cells: both halves hold rows * (training + 1) - guard_rows * (guard + 1) cells
+                const int half_count = rows * (training + 1) - guard_rows * (guard + 1);
+                split_window_interior(outer, inner, training, guard, greatest, half_count > 0 ? 1.0 / half_count : 0.0,
+                    interior_begin, interior_end, estimateRow);
+
+                for (int s = interior_end; s < tile.s_end; s++) {
+                    edge_estimate(s);
+                }
+            }
+        }
+
+        // OS-CFAR histogram: the map is quantized to logarithmic bins spanning
+        // OS_DYNAMIC_RANGE below its maximum
+        constexpr int OS_HISTOGRAM_BINS = 4096;
+        constexpr double OS_DYNAMIC_RANGE = 1e-15;
+
+        // Scale factor for an ordered-statistic threshold: solves
+        // prod_{i < k} (n - i) / (n - i + alpha) = pfa for exponentially distributed cells
+        inline double ordered_statistic_alpha(int n, int k, double pfa) {
+            auto false_alarm = [n, k](double alpha) {
+                double p = 1.0;
+                for (int i = 0; i < k; i++) {
+                    p *= (n - i) / (n - i + alpha);
+                }
+                return p;
+            };
+            double low = 0.0, high = 1.0;
+            while (false_alarm(high) > pfa && high < 1e12) {
+                high *= 2;
+            }
+            for (int iteration = 0; iteration < 100; iteration++) {
+                double mid = 0.5 * (low + high);
+                (false_alarm(mid) > pfa ? low : high) = mid;
+            }
+            return 0.5 * (low + high);
+        }
+
+        // Logarithmic quantization of one receiver for OS-CFAR: bin b covers
+        // [floor * 2^(b * width), floor * 2^((b + 1) * width))
+        struct OsQuantizer {
+            double floor = 0;
+            double width = 0;
+        };
+
+        // Quantize chirps [c_begin, c_end), stored range-major so the columns the OS window
+        // slides over are contiguous
+        template <typename T>
+        void quantize_rows(const RadarData::BasicMagnitudeMap<T>& magnitude, int r, const OsQuantizer& quantizer,
+            int c_begin, int c_end, std::vector<uint16_t>& bins) {
+            const int num_chirps = magnitude.num_chirps();
+            const int num_samples = magnitude.num_samples();
+            for (int c = c_begin; c < c_end; c++) {
+                const T* row = magnitude.row(r, c);
+                for (int s = 0; s < num_samples; s++) {
+                    double value = row[s];
+                    int bin = value > quantizer.floor ? static_cast<int>(std::log2(value / quantizer.floor) / quantizer.width) : 0;
+                    bins[static_cast<size_t>(s) * num_chirps + c] = static_cast<uint16_t>(std::min(bin, OS_HISTOGRAM_BINS - 1));
+                }
+            }
+        }
+
+        // OrderedStatistic: the rank-th training cell per cell under test. A histogram of the
+        // quantized window slides along range: each step drops the leaving column, adds the
+        // entering one, and swaps the guard-box columns, so it never sorts a window. A cursor
+        // bin tracks the count below it, so the selection only moves as far as the rank did.
+        // The estimate is the centre of the selected bin.
+        inline void ordered_statistic_estimates(const std::vector<uint16_t>& bins, const OsQuantizer& quantizer,
+            int num_chirps, int num_samples, int training, int guard, double rank, const Tile& tile,
+            std::vector<double>& estimates) {
+            thread_local std::vector<int> histogram;
+            histogram.resize(OS_HISTOGRAM_BINS);
+
+            for (int c = tile.c_begin; c < tile.c_end; c++) {
+                const int c0 = std::max(c - training, 0), c1 = std::min(c + training, num_chirps - 1);
+                const int gc0 = std::max(c - guard, 0), gc1 = std::min(c + guard, num_chirps - 1);
+                double* estimateRow = estimates.data() + static_cast<size_t>(c) * num_samples;
+                if (quantizer.width <= 0) {
+                    std::fill(estimateRow + tile.s_begin, estimateRow + tile.s_end, 0.0);
+                    continue;
+                }
+
+                std::fill(histogram.begin(), histogram.end(), 0);
+                int count = 0;
+                int cursor = 0;     // Selected bin
+                int below = 0;      // Cells in bins below the cursor
+
+                // Add (+1) or remove (-1) chirps [first, last] of range column s
+                auto update = [&](int s, int first, int last, int delta) {
+                    const uint16_t* column = bins.data() + static_cast<size_t>(s) * num_chirps;
+                    for (int cc = first; cc <= last; cc++) {
+                        int bin = column[cc];
+                        histogram[bin] += delta;
+                        below += bin < cursor ? delta : 0;
+                    }
+                    count += delta * (last - first + 1);
+                };
+
+                // Window of the first cell: training columns minus the guard rows of the guard columns
+                const int s_first = tile.s_begin;
+                for (int s = std::max(s_first - training, 0); s <= std::min(s_first + training, num_samples - 1); s++) {
+                    update(s, c0, c1, 1);
+                    if (std::abs(s - s_first) <= guard) {
+                        update(s, gc0, gc1, -1);
+                    }
+                }
+
+                for (int s = s_first; s < tile.s_end; s++) {
+                    if (count > 0) {
+                        const int k = std::min(std::max(static_cast<int>(std::lround(rank * count)), 1), count);
+                        while (below + histogram[cursor] < k) {
+                            below += histogram[cursor++];
+                        }
+                        while (below >= k) {
+                            below -= histogram[--cursor];
+                        }
+                        estimateRow[s] = quantizer.floor * std::exp2((cursor + 0.5) * quantizer.width);
+                    }
+                    else {
+                        estimateRow[s] = 0.0;
+                    }
+
+                    // Slide to s + 1
+                    if (s - training >= 0) update(s - training, c0, c1, -1);
+                    if (s + 1 + training < num_samples) update(s + 1 + training, c0, c1, 1);
+                    if (s - guard >= 0) update(s - guard, gc0, gc1, 1);
+                    if (s + 1 + guard < num_samples) update(s + 1 + guard, gc0, gc1, -1);
+                }
+            }
+        }
+
+        // Threshold the cells of one tile against their noise estimates (training sums when
+        // averaging) and collect its peaks in chirp-major order; the diagnostic maps selected in
+        // 'maps' are written along the way
+        template <typename T>
+        void detect_tile(const RadarData::BasicMagnitudeMap<T>& magnitude, int r, const Tile& tile,
+            const std::vector<double>& estimates, bool averaging, T alpha, int training, int guard,
+            CfarMaps* maps, RadarData::PeakList& peaks) {
+            const int num_chirps = magnitude.num_chirps();
+            const int num_samples = magnitude.num_samples();
+            const unsigned flags = maps ? maps->flags : CFAR_MAP_NONE;
+            peaks.clear();
+
+            for (int c = tile.c_begin; c < tile.c_end; c++) {
+                const T* magnitudeRow = magnitude.row(r, c);
+                const double* estimateRow = estimates.data() + static_cast<size_t>(c) * num_samples;
+
+                if (flags == CFAR_MAP_NONE) {
+                    // Peak list only
+                    for (int s = tile.s_begin; s < tile.s_end; s++) {
+                        T noise_level = static_cast<T>(estimateRow[s]);
+                        if (averaging) {
+                            noise_level /= training_cell_count(c, s, num_chirps, num_samples, training, guard);
+                        }
+                        if (magnitudeRow[s] > alpha * noise_level) {
+                            peaks.push_back(std::make_tuple(r, c, s)); // Include receiver index
+                        }
+                    }
+                    continue;
+                }
+
+                RadarData::Real* nciRow = flags & CFAR_MAP_NCI ? maps->nci.row(0, c) : nullptr;
+                RadarData::Real* foldedRow = flags & CFAR_MAP_FOLDED_NCI ? maps->foldedNci.row(0, c) : nullptr;
+                RadarData::Real* noiseRow = flags & CFAR_MAP_NOISE ? maps->noiseEstimation.row(0, c) : nullptr;
+                RadarData::Real* thresholdRow = flags & CFAR_MAP_THRESHOLD ? maps->thresholdingMap.row(0, c) : nullptr;
+
+                for (int s = tile.s_begin; s < tile.s_end; s++) {
+                    T magnitude_cut = magnitudeRow[s];
+                    int training_count = training_cell_count(c, s, num_chirps, num_samples, training, guard);
+
+                    // Map under test, summed over its receivers
+                    if (nciRow) {
+                        nciRow[s] = r == 0 ? magnitude_cut : nciRow[s] + magnitude_cut;
+                    }
 
-                    // Calculate average noise level
-                    nci[c][s] = noise_level / training_count; // Average noise level
-                    foldedNci[c][s] = noise_level;
-                    noise_level /= training_count;
-                    noiseEstimation[c][s] = noise_level;
+                    // Calculate noise level: the training sum for cell averaging, otherwise the estimate
+                    T noise_level = static_cast<T>(estimateRow[s]);
+                    T folded = noise_level;
+                    if (averaging) {
+                        noise_level /= training_count;
+                    }
+                    else {
+                        folded = noise_level * training_count;
+                    }
+                    if (foldedRow) {
+                        foldedRow[s] = folded;
+                    }
+                    if (noiseRow) {
+                        noiseRow[s] = noise_level;
+                    }
 
                     // Calculate threshold
-                    double threshold = alpha * noise_level;
-                    thresholdingMap[c][s] = threshold;
+                    T threshold = alpha * noise_level;
+                    if (thresholdRow) {
+                        thresholdRow[s] = threshold;
+                    }
 
                     // Detect peak
-                    if (magnitude > threshold) {
-                        peakList.push_back(std::make_tuple(r, c, s)); // Include receiver index
+                    if (magnitude_cut > threshold) {
+                        peaks.push_back(std::make_tuple(r, c, s)); // Include receiver index
+                    }
+                }
+            }
+        }
+
+        // Per-call buffers of cfar_peak_detection: the plane-wide table (summed-area table or
+        // range sums), noise estimates and OS bins of the current receiver, and one peak buffer
+        // per tile
+        struct CfarScratch {
+            std::vector<double> table;
+            std::vector<double> estimates;
+            std::vector<uint16_t> bins;
+            std::vector<Tile> tiles;
+            std::vector<RadarData::PeakList> tilePeaks;
+        };
+
+        // Tiles covering a C x S plane in chirp-major order
+        inline void make_tiles(int num_chirps, int num_samples, std::vector<Tile>& tiles) {
+            tiles.clear();
+            for (int c = 0; c < num_chirps; c += CFAR_TILE_CHIRPS) {
+                for (int s = 0; s < num_samples; s += CFAR_TILE_SAMPLES) {
+                    tiles.push_back({ c, std::min(c + CFAR_TILE_CHIRPS, num_chirps),
+                        s, std::min(s + CFAR_TILE_SAMPLES, num_samples) });
+                }
+            }
+        }
+    }
+
+    template <typename T>
+    void compute_magnitude_map(const RadarData::BasicRadarCube<T>& frame, RadarData::BasicMagnitudeMap<T>& magnitude,
+        RadarData::MagnitudeScale scale) {
+        int num_receivers = frame.num_receivers();
+        int num_chirps = frame.num_chirps();
+        int num_samples = frame.num_samples();
+        magnitude.resize(num_receivers, num_chirps, num_samples, scale);
+
+        for (int r = 0; r < num_receivers; r++) {
+            for (int c = 0; c < num_chirps; c++) {
+                RadarData::StridedSpan<const std::complex<T>> samples = frame.samples(r, c);
+                T* row = magnitude.row(r, c);
+                if (scale == RadarData::MagnitudeScale::Power) {
+                    for (int s = 0; s < num_samples; s++) {
+                        row[s] = std::norm(samples[s]);
+                    }
+                }
+                else {
+                    for (int s = 0; s < num_samples; s++) {
+                        row[s] = std::abs(samples[s]);
                     }
                 }
             }
         }
     }
+
+    template <typename T>
+    void compute_nci(const RadarData::BasicMagnitudeMap<T>& magnitude, RadarData::BasicMagnitudeMap<T>& integrated) {
+        int num_receivers = magnitude.num_receivers();
+        int num_chirps = magnitude.num_chirps();
+        int num_samples = magnitude.num_samples();
+        const bool power = magnitude.scale() == RadarData::MagnitudeScale::Power;
+        integrated.resize(1, num_chirps, num_samples, RadarData::MagnitudeScale::Power);
+        std::fill(integrated.data(), integrated.data() + integrated.size(), T(0));
+
+        for (int r = 0; r < num_receivers; r++) {
+            for (int c = 0; c < num_chirps; c++) {
+                const T* row = magnitude.row(r, c);
+                T* sum = integrated.row(0, c);
+                if (power) {
+                    for (int s = 0; s < num_samples; s++) {
+                        sum[s] += row[s];
+                    }
+                }
+                else {
+                    for (int s = 0; s < num_samples; s++) {
+                        sum[s] += row[s] * row[s];
+                    }
+                }
+            }
+        }
+    }
+
+    // Function to perform 2D CFAR-like peak detection
+    template <typename T>
+    void cfar_peak_detection(const RadarData::BasicMagnitudeMap<T>& magnitude, RadarData::PeakList& peakList,
+        const RadarConfig::Config& rconfig, CfarMaps* maps) {
+        int num_receivers = magnitude.num_receivers();
+        int num_chirps = magnitude.num_chirps();
+        int num_samples = magnitude.num_samples();
+
+        // Size the requested diagnostic maps; every cell is written by the receiver 0 pass
+        if (maps) {
+            const RadarData::MagnitudeScale scale = magnitude.scale();
+            if (maps->flags & CFAR_MAP_NCI) maps->nci.resize(1, num_chirps, num_samples, scale);
+            if (maps->flags & CFAR_MAP_FOLDED_NCI) maps->foldedNci.resize(1, num_chirps, num_samples, scale);
+            if (maps->flags & CFAR_MAP_NOISE) maps->noiseEstimation.resize(1, num_chirps, num_samples, scale);
+            if (maps->flags & CFAR_MAP_THRESHOLD) maps->thresholdingMap.resize(1, num_chirps, num_samples, scale);
+        }
+
+        // CFAR parameters
+        
+        T alpha = static_cast<T>(RadarConfig::TRAINING_CELLS  * (std::pow(RadarConfig::FALSE_ALARM_RATE, -1.0 / RadarConfig::TRAINING_CELLS) - 1));
+        const int training = RadarConfig::TRAINING_CELLS;
+        const int guard = RadarConfig::GUARD_CELLS;
+        if (rconfig.cfar_mode == RadarConfig::CfarMode::OrderedStatistic) {
+            // Scale for the full-window rank; edge cells keep the same rank fraction
+            const int window = (2 * training + 1) * (2 * training + 1) - (2 * guard + 1) * (2 * guard + 1);
+            const int k = std::min(std::max(static_cast<int>(std::lround(rconfig.cfar_os_rank * window)), 1), window);
+            alpha = static_cast<T>(ordered_statistic_alpha(window, k, RadarConfig::FALSE_ALARM_RATE));
+        }
+        const bool averaging = rconfig.cfar_mode == RadarConfig::CfarMode::CellAveraging;
+
+        // Buffers reused across frames. Named through a reference so the pool workers use the
+        // calling thread's instance rather than their own.
+        thread_local CfarScratch threadScratch;
+        CfarScratch& scratch = threadScratch;
+        std::vector<double>& table = scratch.table;
+        std::vector<double>& estimates = scratch.estimates;
+        std::vector<uint16_t>& bins = scratch.bins;
+        std::vector<Tile>& tiles = scratch.tiles;
+        std::vector<RadarData::PeakList>& tilePeaks = scratch.tilePeaks;
+        estimates.resize(static_cast<size_t>(num_chirps) * num_samples);
+        make_tiles(num_chirps, num_samples, tiles);
+        tilePeaks.resize(tiles.size());
+
+        // Chirp bands for the plane-wide passes that run in parallel
+        Parallel::ThreadPool& pool = Parallel::default_pool();
+        const size_t bands = (static_cast<size_t>(num_chirps) + CFAR_TILE_CHIRPS - 1) / CFAR_TILE_CHIRPS;
+        auto for_each_band = [&](auto&& pass) {
+            pool.parallel_for(bands, [&](size_t band) {
+                const int c_begin = static_cast<int>(band) * CFAR_TILE_CHIRPS;
+                pass(c_begin, std::min(c_begin + CFAR_TILE_CHIRPS, num_chirps));
+            });
+        };
+
+        // Perform CFAR detection for each receiver
+        for (int r = 0; r < num_receivers; r++) {
+            // Tables shared by the tiles of this receiver
+            OsQuantizer quantizer;
+            if (averaging && rconfig.cfar_engine == RadarConfig::CfarEngine::IntegralImage) {
+                build_summed_area_table(magnitude, r, table);
+            }
+            else if (averaging && rconfig.cfar_engine == RadarConfig::CfarEngine::SlidingWindow) {
+                table.resize(2 * estimates.size());
+                for_each_band([&](int c_begin, int c_end) {
+                    sliding_range_pass(magnitude, r, training, guard, c_begin, c_end, table);
+                });
+            }
+            else if (rconfig.cfar_mode == RadarConfig::CfarMode::GreatestOf ||
+                rconfig.cfar_mode == RadarConfig::CfarMode::SmallestOf) {
+                build_summed_area_table(magnitude, r, table);
+            }
+            else if (rconfig.cfar_mode == RadarConfig::CfarMode::OrderedStatistic) {
+                double peak = 0;
+                for (int c = 0; c < num_chirps; c++) {
+                    const T* row = magnitude.row(r, c);
+                    for (int s = 0; s < num_samples; s++) {
+                        peak = std::max(peak, static_cast<double>(row[s]));
+                    }
+                }
+                if (peak > 0) {
+                    quantizer.floor = peak * OS_DYNAMIC_RANGE;
+                    quantizer.width = std::log2(peak / quantizer.floor) / OS_HISTOGRAM_BINS;
+                    bins.resize(estimates.size());
+                    for_each_band([&](int c_begin, int c_end) {
+                        quantize_rows(magnitude, r, quantizer, c_begin, c_end, bins);
+                    });
+                }
+            }
+
+            // Estimate and test every tile; each tile writes its own cells and peak buffer
+            pool.parallel_for(tiles.size(), [&](size_t t) {
+                const Tile& tile = tiles[t];
+                switch (rconfig.cfar_mode) {
+                case RadarConfig::CfarMode::CellAveraging:
+                    // Training sums, averaged below
+                    switch (rconfig.cfar_engine) {
+                    case RadarConfig::CfarEngine::Direct:
+                        training_sums_direct(magnitude, r, training, guard, tile, estimates);
+                        break;
+                    case RadarConfig::CfarEngine::IntegralImage:
+                        training_sums_integral(table, num_chirps, num_samples, training, guard, tile, estimates);
+                        break;
+                    case RadarConfig::CfarEngine::SlidingWindow:
+                        training_sums_sliding(table, num_chirps, num_samples, training, guard, tile, estimates);
+                        break;
+                    }
+                    break;
+                case RadarConfig::CfarMode::GreatestOf:
+                case RadarConfig::CfarMode::SmallestOf:
+                    split_window_estimates(table, num_chirps, num_samples, training, guard,
+                        rconfig.cfar_mode == RadarConfig::CfarMode::GreatestOf, tile, estimates);
+                    break;
+                case RadarConfig::CfarMode::OrderedStatistic:
+                    ordered_statistic_estimates(bins, quantizer, num_chirps, num_samples, training, guard,
+                        rconfig.cfar_os_rank, tile, estimates);
+                    break;
+                }
+
+                detect_tile(magnitude, r, tile, estimates, averaging, alpha, training, guard, maps, tilePeaks[t]);
+            });
+
+            // Merge in tile order, then restore the chirp-major order of a serial scan
+            size_t first = peakList.size();
+            for (const auto& peaks : tilePeaks) {
+                peakList.insert(peakList.end(), peaks.begin(), peaks.end());
+            }
+            std::sort(peakList.begin() + first, peakList.end());
+        }
+    }
+
+    template <typename T>
+    void group_peaks(const RadarData::BasicMagnitudeMap<T>& magnitude, RadarData::PeakList& peakList, int radius) {
+        if (radius <= 0) {
+            return;
+        }
+        int num_receivers = magnitude.num_receivers();
+        int num_chirps = magnitude.num_chirps();
+        int num_samples = magnitude.num_samples();
+
+        auto is_local_maximum = [&](int r, int c, int s) {
+            const T value = magnitude(r, c, s);
+            for (int nc = std::max(c - radius, 0); nc <= std::min(c + radius, num_chirps - 1); nc++) {
+                const T* row = magnitude.row(r, nc);
+                for (int ns = std::max(s - radius, 0); ns <= std::min(s + radius, num_samples - 1); ns++) {
+                    // A plateau keeps only its first cell in chirp-major order
+                    bool earlier = nc < c || (nc == c && ns < s);
+                    if (row[ns] > value || (earlier && row[ns] == value)) {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        };
+
+        size_t kept = 0;
+        for (const auto& peak : peakList) {
+            int r = std::get<0>(peak);
+            int c = std::get<1>(peak);
+            int s = std::get<2>(peak);
+            if (r < 0 || r >= num_receivers || c < 0 || c >= num_chirps || s < 0 || s >= num_samples) {
+                std::cerr << "Invalid peak indices: (" << r << ", " << c << ", " << s << ")" << std::endl;
+                continue;
+            }
+            if (is_local_maximum(r, c, s)) {
+                peakList[kept++] = peak;
+            }
+        }
+        peakList.resize(kept);
+    }
+
+    // Frame overload: integrates |x|^2 into reused thread-local maps first
+    template <typename T>
+    void cfar_peak_detection(const RadarData::BasicRadarCube<T>& frame, RadarData::PeakList& peakList, CfarMaps* maps) {
+        thread_local RadarData::BasicMagnitudeMap<T> magnitude;
+        thread_local RadarData::BasicMagnitudeMap<T> integrated;
+        compute_magnitude_map(frame, magnitude, RadarData::MagnitudeScale::Power);
+        compute_nci(magnitude, integrated);
+        cfar_peak_detection(integrated, peakList, RadarConfig::Config(), maps);
+    }
+
+    template void compute_magnitude_map<float>(const RadarData::FrameF& frame, RadarData::MagnitudeMapF& magnitude,
+        RadarData::MagnitudeScale scale);
+    template void compute_magnitude_map<double>(const RadarData::Frame& frame, RadarData::MagnitudeMap& magnitude,
+        RadarData::MagnitudeScale scale);
+    template void compute_nci<float>(const RadarData::MagnitudeMapF& magnitude, RadarData::MagnitudeMapF& integrated);
+    template void compute_nci<double>(const RadarData::MagnitudeMap& magnitude, RadarData::MagnitudeMap& integrated);
+    template void cfar_peak_detection<float>(const RadarData::MagnitudeMapF& magnitude, RadarData::PeakList& peakList,
+        const RadarConfig::Config& rconfig, CfarMaps* maps);
+    template void cfar_peak_detection<double>(const RadarData::MagnitudeMap& magnitude, RadarData::PeakList& peakList,
+        const RadarConfig::Config& rconfig, CfarMaps* maps);
+    template void group_peaks<float>(const RadarData::MagnitudeMapF& magnitude, RadarData::PeakList& peakList, int radius);
+    template void group_peaks<double>(const RadarData::MagnitudeMap& magnitude, RadarData::PeakList& peakList, int radius);
+    template void cfar_peak_detection<float>(const RadarData::FrameF& frame, RadarData::PeakList& peakList, CfarMaps* maps);
+    template void cfar_peak_detection<double>(const RadarData::Frame& frame, RadarData::PeakList& peakList, CfarMaps* maps);
 }
@@ -2,12 +2,67 @@
 #define PEAK_DETECTION_HPP
 
 #include "datatypes.hpp"
+#include "config.hpp"
 
 namespace PeakDetection {
-    // Function to perform CFAR-like peak detection
-    void cfar_peak_detection(const RadarData::Frame& frame, RadarData::NCI& nci, RadarData::FoldedNCI& foldedNci,
-        RadarData::NoiseEstimation& noiseEstimation, RadarData::ThresholdingMap& thresholdingMap,
-        RadarData::PeakList& peakList);
+    // CFAR work unit: tiles of CFAR_TILE_CHIRPS x CFAR_TILE_SAMPLES cells run in parallel on the
+    // shared thread pool
+    constexpr int CFAR_TILE_CHIRPS = 8;
+    constexpr int CFAR_TILE_SAMPLES = 256;
+
+    // Compute |x| (Linear) or |x|^2 (Power) of every cell once into a contiguous map that CFAR,
+    // NCI generation and the target stages read instead of re-evaluating std::abs
+    template <typename T>
+    void compute_magnitude_map(const RadarData::BasicRadarCube<T>& frame, RadarData::BasicMagnitudeMap<T>& magnitude,
+        RadarData::MagnitudeScale scale = RadarData::MagnitudeScale::Linear);
+
+    // Non-coherent integration: sum |x|^2 over the receivers (virtual channels) of a magnitude map
+    // into a single-receiver Power map, the one range-Doppler map CFAR has to test
+    template <typename T>
+    void compute_nci(const RadarData::BasicMagnitudeMap<T>& magnitude, RadarData::BasicMagnitudeMap<T>& integrated);
+
+    // Diagnostic maps cfar_peak_detection can fill besides the peak list, combined as a mask
+    enum CfarMapFlags : unsigned {
+        CFAR_MAP_NONE = 0,
+        CFAR_MAP_NCI = 1u << 0,             // Tested map summed over its receivers
+        CFAR_MAP_FOLDED_NCI = 1u << 1,      // Noise estimate times the training cell count
+        CFAR_MAP_NOISE = 1u << 2,           // Noise level per cell
+        CFAR_MAP_THRESHOLD = 1u << 3,       // Detection threshold per cell
+        CFAR_MAP_ALL = CFAR_MAP_NCI | CFAR_MAP_FOLDED_NCI | CFAR_MAP_NOISE | CFAR_MAP_THRESHOLD
+    };
+
+    // Requested diagnostic maps. Only the maps selected by 'flags' are resized and written; keep the
+    // struct across frames to reuse their storage.
+    struct CfarMaps {
+        unsigned flags = CFAR_MAP_NONE;
+        RadarData::NCI nci;
+        RadarData::FoldedNCI foldedNci;
+        RadarData::NoiseEstimation noiseEstimation;
+        RadarData::ThresholdingMap thresholdingMap;
+    };
+
+    // Function to perform CFAR-like peak detection on a magnitude map; the noise estimate is taken
+    // in the scale of the map by rconfig.cfar_mode (cell averaging sums with rconfig.cfar_engine,
+    // greatest/smallest-of compares half windows with an SSE2 kernel, ordered statistic uses a
+    // scalar sliding histogram). Each receiver of the map
+    // is tested in turn, so an NCI map takes a single pass. Without 'maps' only the peak list is
+    // produced; otherwise the maps selected by maps->flags are filled, the noise and threshold maps
+    // holding the last receiver tested.
+    template <typename T>
+    void cfar_peak_detection(const RadarData::BasicMagnitudeMap<T>& magnitude, RadarData::PeakList& peakList,
+        const RadarConfig::Config& rconfig = RadarConfig::Config(), CfarMaps* maps = nullptr);
+
+    // Group detections into one per target: keep a peak only if its cell is the maximum of the
+    // (2 * radius + 1)^2 neighbourhood of the map it was detected on (ties go to the earlier cell).
+    // The list keeps its order; radius 0 leaves it untouched.
+    template <typename T>
+    void group_peaks(const RadarData::BasicMagnitudeMap<T>& magnitude, RadarData::PeakList& peakList, int radius);
+
+    // Function to perform CFAR-like peak detection, instantiated for Frame and FrameF: one CFAR
+    // pass over the NCI of the frame, reporting peaks on receiver 0
+    template <typename T>
+    void cfar_peak_detection(const RadarData::BasicRadarCube<T>& frame, RadarData::PeakList& peakList,
+        CfarMaps* maps = nullptr);
 }
 
 #endif // PEAK_DETECTION_HPP
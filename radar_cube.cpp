@@ -0,0 +1,177 @@
+#include "radar_cube.hpp"
+#include <algorithm>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace RadarData {
+    template <typename T>
+    BasicRadarCube<T>::BasicRadarCube(int num_receivers, int num_chirps, int num_samples, CubeLayout layout) {
+        resize(num_receivers, num_chirps, num_samples, layout);
+    }
+
+    template <typename T>
+    BasicRadarCube<T>::BasicRadarCube(const BasicRadarCube& other) {
+        *this = other;
+    }
+
+    template <typename T>
+    BasicRadarCube<T>::BasicRadarCube(BasicRadarCube&& other) noexcept {
+        *this = std::move(other);
+    }
+
+    template <typename T>
+    BasicRadarCube<T>& BasicRadarCube<T>::operator=(const BasicRadarCube& other) {
+        if (this != &other) {
+            resize(other.num_receivers_, other.num_chirps_, other.num_samples_, other.layout_);
+            std::copy(other.data_, other.data_ + other.size(), data_);
+        }
+        return *this;
+    }
+
+    template <typename T>
+    BasicRadarCube<T>& BasicRadarCube<T>::operator=(BasicRadarCube&& other) noexcept {
+        if (this != &other) {
+            release();
+            data_ = std::exchange(other.data_, nullptr);
+            capacity_ = std::exchange(other.capacity_, 0);
+            num_receivers_ = std::exchange(other.num_receivers_, 0);
+            num_chirps_ = std::exchange(other.num_chirps_, 0);
+            num_samples_ = std::exchange(other.num_samples_, 0);
+            layout_ = other.layout_;
+            update_strides();
+            other.update_strides();
+        }
+        return *this;
+    }
+
+    template <typename T>
+    BasicRadarCube<T>::~BasicRadarCube() {
+        release();
+    }
+
+    template <typename T>
+    void BasicRadarCube<T>::resize(int num_receivers, int num_chirps, int num_samples) {
+        resize(num_receivers, num_chirps, num_samples, layout_);
+    }
+
+    template <typename T>
+    void BasicRadarCube<T>::resize(int num_receivers, int num_chirps, int num_samples, CubeLayout layout) {
+        reshape(num_receivers, num_chirps, num_samples, layout);
+        set_zero();
+    }
+
+    template <typename T>
+    void BasicRadarCube<T>::reshape(int num_receivers, int num_chirps, int num_samples, CubeLayout layout) {
+        num_receivers_ = std::max(num_receivers, 0);
+        num_chirps_ = std::max(num_chirps, 0);
+        num_samples_ = std::max(num_samples, 0);
+        layout_ = layout;
+        update_strides();
+
+        size_t required = size();
+        if (required > capacity_) {
+            release();
+            void* memory = ::operator new(required * sizeof(value_type), std::align_val_t(ALIGNMENT));
+            data_ = static_cast<value_type*>(memory);
+            capacity_ = required;
+            std::uninitialized_fill_n(data_, capacity_, value_type(0, 0));
+        }
+    }
+
+    template <typename T>
+    void BasicRadarCube<T>::swap(BasicRadarCube& other) noexcept {
+        std::swap(data_, other.data_);
+        std::swap(capacity_, other.capacity_);
+        std::swap(num_receivers_, other.num_receivers_);
+        std::swap(num_chirps_, other.num_chirps_);
+        std::swap(num_samples_, other.num_samples_);
+        std::swap(layout_, other.layout_);
+        update_strides();
+        other.update_strides();
+    }
+
+    template <typename T>
+    void BasicRadarCube<T>::set_zero() {
+        std::fill_n(data_, size(), value_type(0, 0));
+    }
+
+    template <typename T>
+    void BasicRadarCube<T>::update_strides() {
+        const size_t R = static_cast<size_t>(num_receivers_);
+        const size_t C = static_cast<size_t>(num_chirps_);
+        const size_t S = static_cast<size_t>(num_samples_);
+        switch (layout_) {
+        case CubeLayout::ReceiverChirpSample:
+            sample_stride_ = 1;
+            chirp_stride_ = S;
+            receiver_stride_ = C * S;
+            break;
+        case CubeLayout::SampleChirpReceiver:
+            receiver_stride_ = 1;
+            chirp_stride_ = R;
+            sample_stride_ = C * R;
+            break;
+        case CubeLayout::ReceiverSampleChirp:
+            chirp_stride_ = 1;
+            sample_stride_ = C;
+            receiver_stride_ = S * C;
+            break;
+        }
+    }
+
+    template <typename T>
+    void BasicRadarCube<T>::release() {
+        if (data_ != nullptr) {
+            // std::complex<T> is trivially destructible, so only the storage is freed
+            ::operator delete(data_, std::align_val_t(ALIGNMENT));
+        }
+        data_ = nullptr;
+        capacity_ = 0;
+    }
+
+    template class BasicRadarCube<float>;
+    template class BasicRadarCube<double>;
+
+    RawRadarCube::RawRadarCube(int num_receivers, int num_chirps, int num_samples) {
+        resize(num_receivers, num_chirps, num_samples);
+    }
+
+    void RawRadarCube::resize(int num_receivers, int num_chirps, int num_samples) {
+        num_receivers_ = std::max(num_receivers, 0);
+        num_chirps_ = std::max(num_chirps, 0);
+        num_samples_ = std::max(num_samples, 0);
+        samples_.assign(static_cast<size_t>(num_receivers_) * num_chirps_ * num_samples_, 0);
+    }
+
+    void RawRadarCube::set_zero() {
+        std::fill(samples_.begin(), samples_.end(), int16_t(0));
+    }
+
+    template <typename T>
+    BasicMagnitudeMap<T>::BasicMagnitudeMap(int num_receivers, int num_chirps, int num_samples, MagnitudeScale scale) {
+        resize(num_receivers, num_chirps, num_samples, scale);
+    }
+
+    template <typename T>
+    void BasicMagnitudeMap<T>::resize(int num_receivers, int num_chirps, int num_samples, MagnitudeScale scale) {
+        num_receivers_ = std::max(num_receivers, 0);
+        num_chirps_ = std::max(num_chirps, 0);
+        num_samples_ = std::max(num_samples, 0);
+        scale_ = scale;
+        values_.resize(static_cast<size_t>(num_receivers_) * num_chirps_ * num_samples_);
+    }
+
+    template class BasicMagnitudeMap<float>;
+    template class BasicMagnitudeMap<double>;
+
+    template <typename T>
+    void BasicSnapshotMatrix<T>::resize(size_t num_peaks, size_t num_channels) {
+        num_peaks_ = num_peaks;
+        num_channels_ = num_channels;
+        values_.resize(num_peaks_ * num_channels_);
+    }
+
+    template class BasicSnapshotMatrix<float>;
+    template class BasicSnapshotMatrix<double>;
+}
@@ -0,0 +1,299 @@
+#ifndef RADAR_CUBE_HPP
+#define RADAR_CUBE_HPP
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace RadarData {
+    // Memory order of the three cube axes (slowest to fastest varying)
+    enum class CubeLayout {
+        ReceiverChirpSample, // R x C x S, sample rows contiguous (range processing)
+        SampleChirpReceiver, // S x C x R, receiver vectors contiguous (array processing)
+        ReceiverSampleChirp  // R x S x C, chirp rows contiguous (Doppler processing)
+    };
+
+    // Non-owning view of a strided run of elements along one cube axis
+    template <typename T>
+    class StridedSpan {
+    public:
+        StridedSpan(T* data, size_t size, size_t stride) : data_(data), size_(size), stride_(stride) {}
+
+        T& operator[](size_t i) const { return data_[i * stride_]; }
+        T* data() const { return data_; }
+        size_t size() const { return size_; }
+        size_t stride() const { return stride_; }
+        bool is_contiguous() const { return stride_ == 1; }
+
+    private:
+        T* data_;
+        size_t size_;
+        size_t stride_;
+    };
+
+    // Non-owning view of a contiguous run of elements
+    template <typename T>
+    class Span {
+    public:
+        Span() = default;
+        Span(T* data, size_t size) : data_(data), size_(size) {}
+
+        T& operator[](size_t i) const { return data_[i]; }
+        T* data() const { return data_; }
+        size_t size() const { return size_; }
+        bool empty() const { return size_ == 0; }
+        T* begin() const { return data_; }
+        T* end() const { return data_ + size_; }
+
+    private:
+        T* data_ = nullptr;
+        size_t size_ = 0;
+    };
+
+    // Receivers x chirps x samples radar cube of std::complex<T> held in one 64-byte
+    // aligned allocation. resize() keeps the existing storage when it is large enough,
+    // so a cube can be reused across frames without reallocating. Instantiated for
+    // float and double.
+    template <typename T>
+    class BasicRadarCube {
+    public:
+        using scalar_type = T;
+        using value_type = std::complex<T>;
+        static constexpr size_t ALIGNMENT = 64;
+
+        BasicRadarCube() = default;
+        BasicRadarCube(int num_receivers, int num_chirps, int num_samples,
+            CubeLayout layout = CubeLayout::ReceiverChirpSample);
+        BasicRadarCube(const BasicRadarCube& other);
+        BasicRadarCube(BasicRadarCube&& other) noexcept;
+        BasicRadarCube& operator=(const BasicRadarCube& other);
+        BasicRadarCube& operator=(BasicRadarCube&& other) noexcept;
+        ~BasicRadarCube();
+
+        // Copy of a cube of another precision, keeping its dimensions and layout
+        template <typename U>
+        void assign(const BasicRadarCube<U>& other) {
+            resize(other.num_receivers(), other.num_chirps(), other.num_samples(), other.layout());
+            const std::complex<U>* source = other.data();
+            for (size_t i = 0; i < size(); ++i) {
+                data_[i] = value_type(static_cast<T>(source[i].real()), static_cast<T>(source[i].imag()));
+            }
+        }
+
+        // Change dimensions, keeping the current layout; contents are zeroed
+        void resize(int num_receivers, int num_chirps, int num_samples);
+        void resize(int num_receivers, int num_chirps, int num_samples, CubeLayout layout);
+        void set_zero();
+        // Change dimensions and layout without clearing; contents are unspecified
+        void reshape(int num_receivers, int num_chirps, int num_samples, CubeLayout layout);
+        void swap(BasicRadarCube& other) noexcept;
+
+        int num_receivers() const { return num_receivers_; }
+        int num_chirps() const { return num_chirps_; }
+        int num_samples() const { return num_samples_; }
+        size_t size() const { return static_cast<size_t>(num_receivers_) * num_chirps_ * num_samples_; }
+        bool empty() const { return size() == 0; }
+        CubeLayout layout() const { return layout_; }
+
+        size_t receiver_stride() const { return receiver_stride_; }
+        size_t chirp_stride() const { return chirp_stride_; }
+        size_t sample_stride() const { return sample_stride_; }
+
+        value_type* data() { return data_; }
+        const value_type* data() const { return data_; }
+
+        value_type& operator()(int r, int c, int s) {
+            return data_[r * receiver_stride_ + c * chirp_stride_ + s * sample_stride_];
+        }
+        const value_type& operator()(int r, int c, int s) const {
+            return data_[r * receiver_stride_ + c * chirp_stride_ + s * sample_stride_];
+        }
+
+        // All samples of one chirp (range axis)
+        StridedSpan<value_type> samples(int r, int c) {
+            return StridedSpan<value_type>(&(*this)(r, c, 0), num_samples_, sample_stride_);
+        }
+        StridedSpan<const value_type> samples(int r, int c) const {
+            return StridedSpan<const value_type>(&(*this)(r, c, 0), num_samples_, sample_stride_);
+        }
+
+        // One sample across all chirps (Doppler axis)
+        StridedSpan<value_type> chirps(int r, int s) {
+            return StridedSpan<value_type>(&(*this)(r, 0, s), num_chirps_, chirp_stride_);
+        }
+        StridedSpan<const value_type> chirps(int r, int s) const {
+            return StridedSpan<const value_type>(&(*this)(r, 0, s), num_chirps_, chirp_stride_);
+        }
+
+        // One range-Doppler cell across all receivers (array axis)
+        StridedSpan<value_type> receivers(int c, int s) {
+            return StridedSpan<value_type>(&(*this)(0, c, s), num_receivers_, receiver_stride_);
+        }
+        StridedSpan<const value_type> receivers(int c, int s) const {
+            return StridedSpan<const value_type>(&(*this)(0, c, s), num_receivers_, receiver_stride_);
+        }
+
+    private:
+        void update_strides();
+        void release();
+
+        value_type* data_ = nullptr;
+        size_t capacity_ = 0;
+        int num_receivers_ = 0;
+        int num_chirps_ = 0;
+        int num_samples_ = 0;
+        CubeLayout layout_ = CubeLayout::ReceiverChirpSample;
+        size_t receiver_stride_ = 0;
+        size_t chirp_stride_ = 0;
+        size_t sample_stride_ = 0;
+    };
+
+    using RadarCube = BasicRadarCube<double>;
+    using RadarCubeF = BasicRadarCube<float>;
+
+    // Raw ADC cube: receivers x chirps x samples of real 16-bit counts, sample rows
+    // contiguous. Kept as captured until the range FFT widens it.
+    class RawRadarCube {
+    public:
+        RawRadarCube() = default;
+        RawRadarCube(int num_receivers, int num_chirps, int num_samples);
+
+        // Change dimensions; contents are zeroed
+        void resize(int num_receivers, int num_chirps, int num_samples);
+        void set_zero();
+
+        int num_receivers() const { return num_receivers_; }
+        int num_chirps() const { return num_chirps_; }
+        int num_samples() const { return num_samples_; }
+        size_t size() const { return samples_.size(); }
+        bool empty() const { return samples_.empty(); }
+
+        int16_t* data() { return samples_.data(); }
+        const int16_t* data() const { return samples_.data(); }
+
+        int16_t& operator()(int r, int c, int s) {
+            return samples_[(static_cast<size_t>(r) * num_chirps_ + c) * num_samples_ + s];
+        }
+        int16_t operator()(int r, int c, int s) const {
+            return samples_[(static_cast<size_t>(r) * num_chirps_ + c) * num_samples_ + s];
+        }
+
+        // The num_samples() samples of one chirp
+        const int16_t* samples(int r, int c) const {
+            return samples_.data() + (static_cast<size_t>(r) * num_chirps_ + c) * num_samples_;
+        }
+
+    private:
+        std::vector<int16_t> samples_;
+        int num_receivers_ = 0;
+        int num_chirps_ = 0;
+        int num_samples_ = 0;
+    };
+
+    // Scale of the values held by a magnitude map
+    enum class MagnitudeScale {
+        Linear,     // |x|
+        Power       // |x|^2
+    };
+
+    // Real-valued map of one magnitude per cube cell: receivers x chirps x samples with
+    // sample rows contiguous, whatever the layout of the cube it was taken from
+    template <typename T>
+    class BasicMagnitudeMap {
+    public:
+        BasicMagnitudeMap() = default;
+        BasicMagnitudeMap(int num_receivers, int num_chirps, int num_samples, MagnitudeScale scale = MagnitudeScale::Linear);
+
+        // Change dimensions, reusing the storage when it is large enough; contents are not cleared
+        void resize(int num_receivers, int num_chirps, int num_samples, MagnitudeScale scale);
+
+        int num_receivers() const { return num_receivers_; }
+        int num_chirps() const { return num_chirps_; }
+        int num_samples() const { return num_samples_; }
+        MagnitudeScale scale() const { return scale_; }
+        size_t size() const { return values_.size(); }
+        bool empty() const { return values_.empty(); }
+
+        T* data() { return values_.data(); }
+        const T* data() const { return values_.data(); }
+
+        T& operator()(int r, int c, int s) {
+            return values_[(static_cast<size_t>(r) * num_chirps_ + c) * num_samples_ + s];
+        }
+        T operator()(int r, int c, int s) const {
+            return values_[(static_cast<size_t>(r) * num_chirps_ + c) * num_samples_ + s];
+        }
+
+        // The num_samples() values of one chirp
+        T* row(int r, int c) {
+            return values_.data() + (static_cast<size_t>(r) * num_chirps_ + c) * num_samples_;
+        }
+        const T* row(int r, int c) const {
+            return values_.data() + (static_cast<size_t>(r) * num_chirps_ + c) * num_samples_;
+        }
+
+    private:
+        std::vector<T> values_;
+        int num_receivers_ = 0;
+        int num_chirps_ = 0;
+        int num_samples_ = 0;
+        MagnitudeScale scale_ = MagnitudeScale::Linear;
+    };
+
+    using MagnitudeMap = BasicMagnitudeMap<double>;
+    using MagnitudeMapF = BasicMagnitudeMap<float>;
+
+    // Peaks x channels matrix of complex snapshots, one contiguous row of num_channels() values
+    // per peak. resize() reuses the storage when it is large enough, so the matrix can be kept
+    // across frames; rows are handed out as spans that the array stages read in place.
+    template <typename T>
+    class BasicSnapshotMatrix {
+    public:
+        using value_type = std::complex<T>;
+
+        BasicSnapshotMatrix() = default;
+        BasicSnapshotMatrix(size_t num_peaks, size_t num_channels) { resize(num_peaks, num_channels); }
+
+        // Copy of a matrix of another precision
+        template <typename U>
+        void assign(const BasicSnapshotMatrix<U>& other) {
+            resize(other.num_peaks(), other.num_channels());
+            const std::complex<U>* source = other.data();
+            for (size_t i = 0; i < values_.size(); ++i) {
+                values_[i] = value_type(static_cast<T>(source[i].real()), static_cast<T>(source[i].imag()));
+            }
+        }
+
+        // Change dimensions; contents are not cleared
+        void resize(size_t num_peaks, size_t num_channels);
+        void clear() { resize(0, num_channels_); }
+
+        size_t num_peaks() const { return num_peaks_; }
+        size_t num_channels() const { return num_channels_; }
+        // Number of snapshots, as for a container of rows
+        size_t size() const { return num_peaks_; }
+        bool empty() const { return num_peaks_ == 0; }
+
+        value_type* data() { return values_.data(); }
+        const value_type* data() const { return values_.data(); }
+
+        // Snapshot of peak p across all channels
+        Span<value_type> operator[](size_t p) {
+            return Span<value_type>(values_.data() + p * num_channels_, num_channels_);
+        }
+        Span<const value_type> operator[](size_t p) const {
+            return Span<const value_type>(values_.data() + p * num_channels_, num_channels_);
+        }
+
+    private:
+        std::vector<value_type> values_;
+        size_t num_peaks_ = 0;
+        size_t num_channels_ = 0;
+    };
+
+    using SnapshotMatrix = BasicSnapshotMatrix<double>;
+    using SnapshotMatrixF = BasicSnapshotMatrix<float>;
+}
+
+#endif // RADAR_CUBE_HPP
\ No newline at end of file
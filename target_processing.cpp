@@ -6,7 +6,7 @@
 
 namespace TargetProcessing {
     // Placeholder function to calculate time delay
-    double calculate_time_delay(const std::vector<std::complex<double>>& snap) {
+    double calculate_time_delay(const RadarData::PeakSnap& snap) {
         // Example logic: Replace with actual time delay calculation
         if (snap.empty()) {
             std::cerr << "Error: Empty snapshot provided for time delay calculation." << std::endl;
@@ -19,7 +19,7 @@ namespace TargetProcessing {
     }
 
     // Function to calculate Doppler frequency shift
-    double calculate_doppler_shift(const std::vector<std::complex<double>>& snap) {
+    double calculate_doppler_shift(const RadarData::PeakSnap& snap) {
         if (snap.empty()) {
             std::cerr << "Error: Empty snapshot provided for Doppler shift calculation." << std::endl;
             return 0.0;
@@ -35,57 +35,99 @@ namespace TargetProcessing {
         return dopplerShift;
     }
 
-    TargetList detect_targets(const RadarData::PeakSnaps& peakSnaps,
-        const std::vector<std::pair<double, double>>& doaResults) {
-        TargetList targetList;
+    namespace {
+        // Shared body of detect_targets; strength_of(i) gives the signal strength of peak i
+        template <typename StrengthFn>
+        TargetList build_targets(const RadarData::PeakSnaps& peakSnaps,
+            const std::vector<std::pair<double, double>>& doaResults, StrengthFn strength_of) {
+            TargetList targetList;
+
+            // Radar parameters
+            double wavelength = RadarConfig::WAVELENGTH;
+            double d = RadarConfig::ANTENNA_SPACING;
+            double c = 3e8; // Speed of light in m/s
+
+            // Ensure the sizes of peakSnaps and doaResults match
+            if (peakSnaps.size() != doaResults.size()) {
+                std::cerr << "Error: Mismatch between PeakSnaps and DOA results sizes." << std::endl;
+                return targetList;
+            }
 
-        // Radar parameters
-        double wavelength = RadarConfig::WAVELENGTH;
-        double d = RadarConfig::ANTENNA_SPACING;
-        double c = 3e8; // Speed of light in m/s
+            // Iterate over each detected peak
+            for (size_t i = 0; i < peakSnaps.size(); ++i) {
+                RadarData::PeakSnap snap = peakSnaps[i];
+                const auto& doa = doaResults[i];
 
-        // Ensure the sizes of peakSnaps and doaResults match
-        if (peakSnaps.size() != doaResults.size()) {
-            std::cerr << "Error: Mismatch between PeakSnaps and DOA results sizes." << std::endl;
-            return targetList;
-        }
+                // Extract azimuth and elevation
+                double azimuth = doa.first;   // In degrees
+                double elevation = doa.second; // In degrees
 
-        // Iterate over each detected peak
-        for (size_t i = 0; i < peakSnaps.size(); ++i) {
-            const auto& snap = peakSnaps[i];
-            const auto& doa = doaResults[i];
+                // Calculate range using time delay
+                double timeDelay = calculate_time_delay(snap);
+                double range = (c * timeDelay) / 2.0;
 
-            // Extract azimuth and elevation
-            double azimuth = doa.first;   // In degrees
-            double elevation = doa.second; // In degrees
+                // Convert azimuth and elevation to radians
+                double azimuthRad = azimuth * RadarConfig::PI / 180.0;
+                double elevationRad = elevation * RadarConfig::PI / 180.0;
 
-            // Calculate range using time delay
-            double timeDelay = calculate_time_delay(snap);
-            double range = (c * timeDelay) / 2.0;
+                // Convert to Cartesian coordinates
+                double x = range * cos(elevationRad) * cos(azimuthRad);
+                double y = range * cos(elevationRad) * sin(azimuthRad);
+                double z = range * sin(elevationRad);
 
-            // Convert azimuth and elevation to radians
-            double azimuthRad = azimuth * RadarConfig::PI / 180.0;
-            double elevationRad = elevation * RadarConfig::PI / 180.0;
+                // Calculate signal strength
+                double strength = strength_of(i);
 
-            // Convert to Cartesian coordinates
-            double x = range * cos(elevationRad) * cos(azimuthRad);
-            double y = range * cos(elevationRad) * sin(azimuthRad);
-            double z = range * sin(elevationRad);
+                // Calculate relative speed using Doppler shift
+                double dopplerShift = calculate_doppler_shift(snap);
+                double relativeSpeed = (dopplerShift * wavelength) / 2.0;
 
-            // Calculate signal strength
+                // Add the target to the list
+                targetList.push_back({ x, y, z, range, azimuth, elevation, strength, 0.0, relativeSpeed });
+            }
+
+            return targetList;
+        }
+    }
+
+    TargetList detect_targets(const RadarData::PeakSnaps& peakSnaps,
+        const std::vector<std::pair<double, double>>& doaResults) {
+        return build_targets(peakSnaps, doaResults, [&](size_t i) {
             double strength = 0.0;
-            for (const auto& value : snap) {
+            for (const auto& value : peakSnaps[i]) {
                 strength += std::abs(value); // Explicitly use std::abs for std::complex
             }
+            return strength;
+        });
+    }
 
-            // Calculate relative speed using Doppler shift
-            double dopplerShift = calculate_doppler_shift(snap);
-            double relativeSpeed = (dopplerShift * wavelength) / 2.0;
-
-            // Add the target to the list
-            targetList.push_back({ x, y, z, range, azimuth, elevation, strength, 0.0, relativeSpeed });
+    template <typename T>
+    TargetList detect_targets(const RadarData::PeakSnaps& peakSnaps,
+        const std::vector<std::pair<double, double>>& doaResults,
+        const RadarData::PeakList& peakList, const RadarData::BasicMagnitudeMap<T>& magnitude) {
+        if (peakSnaps.size() != peakList.size()) {
+            std::cerr << "Error: Mismatch between PeakSnaps and PeakList sizes." << std::endl;
+            return TargetList();
         }
 
-        return targetList;
+        const bool power = magnitude.scale() == RadarData::MagnitudeScale::Power;
+        return build_targets(peakSnaps, doaResults, [&](size_t i) {
+            // Sum of |x| over the receivers at the peak cell, as for the snap-based overload
+            int chirp = std::get<1>(peakList[i]);
+            int sample = std::get<2>(peakList[i]);
+            double strength = 0.0;
+            for (int r = 0; r < magnitude.num_receivers(); ++r) {
+                double value = magnitude(r, chirp, sample);
+                strength += power ? std::sqrt(value) : value;
+            }
+            return strength;
+        });
     }
+
+    template TargetList detect_targets<float>(const RadarData::PeakSnaps& peakSnaps,
+        const std::vector<std::pair<double, double>>& doaResults,
+        const RadarData::PeakList& peakList, const RadarData::MagnitudeMapF& magnitude);
+    template TargetList detect_targets<double>(const RadarData::PeakSnaps& peakSnaps,
+        const std::vector<std::pair<double, double>>& doaResults,
+        const RadarData::PeakList& peakList, const RadarData::MagnitudeMap& magnitude);
 }
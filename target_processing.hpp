@@ -23,6 +23,13 @@ namespace TargetProcessing {
     TargetList detect_targets(const RadarData::PeakSnaps& peakSnaps,
         const std::vector<std::pair<double, double>>& doaResults);
 
+    // Same, taking each target's strength from the magnitude map at its peak cell instead of
+    // re-evaluating |x| over the snap; peakSnaps must have been synthesized from peakList
+    template <typename T>
+    TargetList detect_targets(const RadarData::PeakSnaps& peakSnaps,
+        const std::vector<std::pair<double, double>>& doaResults,
+        const RadarData::PeakList& peakList, const RadarData::BasicMagnitudeMap<T>& magnitude);
+
     // Function to calculate time delay (placeholder for actual implementation)
     double calculate_time_delay(const RadarData::PeakSnap& snap);
 }
@@ -0,0 +1,109 @@
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <memory>
+
+namespace Parallel {
+    namespace {
+        // Set on pool threads, and on the caller while it runs a job, to keep nested calls serial
+        thread_local bool insideJob = false;
+
+        std::mutex defaultPoolMutex;
+        std::unique_ptr<ThreadPool> defaultPool;
+        unsigned defaultThreadCount = 0;
+    }
+
+    ThreadPool::ThreadPool(unsigned num_threads) {
+        if (num_threads == 0) {
+            num_threads = std::max(std::thread::hardware_concurrency(), 1u);
+        }
+        workers_.reserve(num_threads - 1);
+        for (unsigned i = 1; i < num_threads; i++) {
+            workers_.emplace_back(&ThreadPool::worker_loop, this);
+        }
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    void ThreadPool::parallel_for(size_t count, const std::function<void(size_t)>& task) {
+        if (workers_.empty() || count <= 1 || insideJob) {
+            for (size_t i = 0; i < count; i++) {
+                task(i);
+            }
+            return;
+        }
+
+        std::lock_guard<std::mutex> run(runMutex_);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            task_ = &task;
+            count_ = count;
+            next_.store(0, std::memory_order_relaxed);
+            pending_ = workers_.size();
+            ++generation_;
+        }
+        wake_.notify_all();
+
+        insideJob = true;
+        run_tasks();
+        insideJob = false;
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [this] { return pending_ == 0; });
+        task_ = nullptr;
+    }
+
+    void ThreadPool::run_tasks() {
+        for (size_t i = next_.fetch_add(1, std::memory_order_relaxed); i < count_;
+            i = next_.fetch_add(1, std::memory_order_relaxed)) {
+            (*task_)(i);
+        }
+    }
+
+    void ThreadPool::worker_loop() {
+        insideJob = true;
+        size_t seen = 0;
+        for (;;) {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+            if (stop_) {
+                return;
+            }
+            seen = generation_;
+            lock.unlock();
+
+            run_tasks();
+
+            lock.lock();
+            if (--pending_ == 0) {
+                done_.notify_one();
+            }
+        }
+    }
+
+    void set_thread_count(unsigned num_threads) {
+        std::lock_guard<std::mutex> lock(defaultPoolMutex);
+        if (defaultPool && num_threads == defaultThreadCount) {
+            return;
+        }
+        defaultPool.reset();
+        defaultPool = std::make_unique<ThreadPool>(num_threads);
+        defaultThreadCount = num_threads;
+    }
+
+    ThreadPool& default_pool() {
+        std::lock_guard<std::mutex> lock(defaultPoolMutex);
+        if (!defaultPool) {
+            defaultPool = std::make_unique<ThreadPool>(defaultThreadCount);
+        }
+        return *defaultPool;
+    }
+}
@@ -0,0 +1,57 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Parallel {
+    // Persistent pool of worker threads for the data-parallel stages. The workers are
+    // started once and sleep between jobs, so a job costs a wake-up, not a thread launch.
+    class ThreadPool {
+    public:
+        // num_threads counts the calling thread too; 0 uses every hardware thread
+        explicit ThreadPool(unsigned num_threads = 0);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        // Threads that run a job, including the caller
+        unsigned size() const { return static_cast<unsigned>(workers_.size()) + 1; }
+
+        // Run task(i) for every i in [0, count) on the workers and the calling thread and
+        // return once all have finished. Indices are handed out dynamically, so tasks must
+        // not depend on which thread runs them. A call from inside a task runs serially.
+        void parallel_for(size_t count, const std::function<void(size_t)>& task);
+
+    private:
+        void worker_loop();
+        void run_tasks();
+
+        std::vector<std::thread> workers_;
+        std::mutex runMutex_;           // One job at a time
+        std::mutex mutex_;              // Guards the job state below
+        std::condition_variable wake_;
+        std::condition_variable done_;
+        const std::function<void(size_t)>* task_ = nullptr;
+        size_t count_ = 0;
+        std::atomic<size_t> next_{ 0 };
+        size_t generation_ = 0;
+        size_t pending_ = 0;            // Workers still inside the current job
+        bool stop_ = false;
+    };
+
+    // Size the shared pool used by the pipeline stages (0 = every hardware thread). Must not
+    // be called while a stage is running on it.
+    void set_thread_count(unsigned num_threads);
+
+    // Shared pool, created on first use
+    ThreadPool& default_pool();
+}
+
+#endif // THREAD_POOL_HPP